@@ -0,0 +1,151 @@
+// ============================================================
+// bitboard.cpp — Attack table initialization
+// ============================================================
+
+#include "bitboard.h"
+#include <cstdlib>
+
+Bitboard KNIGHT_ATTACKS[64];
+Bitboard KING_ATTACKS[64];
+Bitboard PAWN_ATTACKS[2][64];
+Bitboard PASSED_PAWN_MASK[2][64];
+
+Bitboard BETWEEN_BB[64][64];
+Bitboard LINE_BB[64][64];
+
+Magic BISHOP_MAGICS[64];
+Magic ROOK_MAGICS[64];
+
+// Sizes are the sums of 2^popcount(mask) over all squares
+static Bitboard BISHOP_TABLE[5248];
+static Bitboard ROOK_TABLE[102400];
+
+static bool bb_init_done = false;
+
+// Builds a step-attack set from a direction table, rejecting wraps
+// across the a/h files (a step may move at most max_df files).
+static Bitboard step_attacks(int sq, const int* dirs, int ndirs, int max_df) {
+    Bitboard b = 0;
+    for (int i = 0; i < ndirs; i++) {
+        int to = sq + dirs[i];
+        if (!sq_valid(to)) continue;
+        if (abs(sq_file(to) - sq_file(sq)) > max_df) continue;
+        b |= sq_bb(to);
+    }
+    return b;
+}
+
+// Reference slider attacks by ray walking; only used to fill the tables.
+static Bitboard sliding_attacks(int sq, Bitboard occ, const int* dirs) {
+    Bitboard b = 0;
+    for (int i = 0; i < 4; i++) {
+        int d = dirs[i];
+        for (int to = sq + d; sq_valid(to); to += d) {
+            if (abs(sq_file(to) - sq_file(to - d)) > 1) break; // Wrapped
+            b |= sq_bb(to);
+            if (occ & sq_bb(to)) break;
+        }
+    }
+    return b;
+}
+
+static uint64_t magic_rand(uint64_t& s) {
+    s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+    return s * 2685821657736338717ULL;
+}
+
+// Fills one square's attack slice, searching for a collision-free magic
+// (PEXT builds need no search: the index is the extracted blocker bits).
+static void init_magic(Magic& m, int sq, const int* dirs, Bitboard* table,
+                       uint64_t& seed) {
+    Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~rank_bb(sq_rank(sq))) |
+                     ((FILE_A_BB | FILE_H_BB) & ~file_bb(sq_file(sq)));
+    m.mask = sliding_attacks(sq, 0, dirs) & ~edges;
+    m.shift = 64 - popcount(m.mask);
+    m.attacks = table;
+
+    // Enumerate all blocker subsets of the mask (Carry-Rippler)
+    Bitboard occ[4096], ref[4096];
+    int size = 0;
+    Bitboard b = 0;
+    do {
+        occ[size] = b;
+        ref[size++] = sliding_attacks(sq, b, dirs);
+        b = (b - m.mask) & m.mask;
+    } while (b);
+
+#ifdef USE_PEXT
+    m.magic = 0;
+    for (int i = 0; i < size; i++) table[m.index(occ[i])] = ref[i];
+    (void)seed;
+#else
+    int epoch[4096] = {0};
+    for (int attempt = 1; ; attempt++) {
+        do {
+            m.magic = magic_rand(seed) & magic_rand(seed) & magic_rand(seed);
+        } while (popcount((m.mask * m.magic) >> 56) < 6);
+
+        bool ok = true;
+        for (int i = 0; i < size && ok; i++) {
+            unsigned idx = m.index(occ[i]);
+            if (epoch[idx] < attempt) {
+                epoch[idx] = attempt;
+                table[idx] = ref[i];
+            } else if (table[idx] != ref[i]) {
+                ok = false;
+            }
+        }
+        if (ok) break;
+    }
+#endif
+}
+
+void init_bitboards() {
+    if (bb_init_done) return;
+    static const int W_PAWN_CAPS[] = { 7, 9 };
+    static const int B_PAWN_CAPS[] = { -7, -9 };
+    for (int sq = 0; sq < 64; sq++) {
+        KNIGHT_ATTACKS[sq] = step_attacks(sq, KNIGHT_DIRS, 8, 2);
+        KING_ATTACKS[sq]   = step_attacks(sq, KING_DIRS, 8, 1);
+        PAWN_ATTACKS[WHITE_SIDE][sq] = step_attacks(sq, W_PAWN_CAPS, 2, 1);
+        PAWN_ATTACKS[BLACK_SIDE][sq] = step_attacks(sq, B_PAWN_CAPS, 2, 1);
+
+        Bitboard files = file_bb(sq_file(sq));
+        if (sq_file(sq) > 0) files |= file_bb(sq_file(sq) - 1);
+        if (sq_file(sq) < 7) files |= file_bb(sq_file(sq) + 1);
+        Bitboard above = 0, below = 0;
+        for (int r = sq_rank(sq) + 1; r < 8; r++)  above |= rank_bb(r);
+        for (int r = sq_rank(sq) - 1; r >= 0; r--) below |= rank_bb(r);
+        PASSED_PAWN_MASK[WHITE_SIDE][sq] = files & above;
+        PASSED_PAWN_MASK[BLACK_SIDE][sq] = files & below;
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bitboard* bishop_next = BISHOP_TABLE;
+    Bitboard* rook_next = ROOK_TABLE;
+    for (int sq = 0; sq < 64; sq++) {
+        init_magic(BISHOP_MAGICS[sq], sq, BISHOP_DIRS, bishop_next, seed);
+        bishop_next += 1ULL << popcount(BISHOP_MAGICS[sq].mask);
+        init_magic(ROOK_MAGICS[sq], sq, ROOK_DIRS, rook_next, seed);
+        rook_next += 1ULL << popcount(ROOK_MAGICS[sq].mask);
+    }
+
+    for (int s1 = 0; s1 < 64; s1++) {
+        for (int s2 = 0; s2 < 64; s2++) {
+            BETWEEN_BB[s1][s2] = LINE_BB[s1][s2] = 0;
+            if (s1 == s2) continue;
+            if (bishop_attacks(s1, 0) & sq_bb(s2)) {
+                LINE_BB[s1][s2] = (bishop_attacks(s1, 0) & bishop_attacks(s2, 0)) |
+                                  sq_bb(s1) | sq_bb(s2);
+                BETWEEN_BB[s1][s2] = bishop_attacks(s1, sq_bb(s2)) &
+                                     bishop_attacks(s2, sq_bb(s1));
+            } else if (rook_attacks(s1, 0) & sq_bb(s2)) {
+                LINE_BB[s1][s2] = (rook_attacks(s1, 0) & rook_attacks(s2, 0)) |
+                                  sq_bb(s1) | sq_bb(s2);
+                BETWEEN_BB[s1][s2] = rook_attacks(s1, sq_bb(s2)) &
+                                     rook_attacks(s2, sq_bb(s1));
+            }
+        }
+    }
+    bb_init_done = true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+// ============================================================
+// bitboard.h — Bitboard type, bit helpers, attack tables
+// ============================================================
+
+#include "types.h"
+
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+
+typedef uint64_t Bitboard;
+
+// ─── Masks ──────────────────────────────────────────────────
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+inline Bitboard sq_bb(int s)      { return 1ULL << s; }
+inline Bitboard file_bb(int f)    { return FILE_A_BB << f; }
+inline Bitboard rank_bb(int r)    { return RANK_1_BB << (r * 8); }
+
+// ─── Bit manipulation ───────────────────────────────────────
+inline int popcount(Bitboard b)   { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b)        { return __builtin_ctzll(b); }
+inline int pop_lsb(Bitboard& b)   { int s = lsb(b); b &= b - 1; return s; }
+inline bool more_than_one(Bitboard b) { return (b & (b - 1)) != 0; }
+
+// ─── Precomputed attack tables ──────────────────────────────
+extern Bitboard KNIGHT_ATTACKS[64];
+extern Bitboard KING_ATTACKS[64];
+extern Bitboard PAWN_ATTACKS[2][64];   // [side][square] squares attacked by a pawn
+
+// ─── Slider attacks (magic bitboards) ───────────────────────
+// Each square owns a slice of a shared attack table, indexed by the
+// relevant blockers: by magic multiplication, or by PEXT when built
+// with USE_PEXT (make PEXT=1) on BMI2 hardware.
+struct Magic {
+    Bitboard  mask;      // Relevant occupancy (ray squares minus edges)
+    Bitboard  magic;
+    Bitboard* attacks;
+    int       shift;
+
+    unsigned index(Bitboard occ) const {
+#ifdef USE_PEXT
+        return (unsigned)_pext_u64(occ, mask);
+#else
+        return (unsigned)(((occ & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern Magic BISHOP_MAGICS[64];
+extern Magic ROOK_MAGICS[64];
+
+inline Bitboard bishop_attacks(int sq, Bitboard occ) {
+    const Magic& m = BISHOP_MAGICS[sq];
+    return m.attacks[m.index(occ)];
+}
+inline Bitboard rook_attacks(int sq, Bitboard occ) {
+    const Magic& m = ROOK_MAGICS[sq];
+    return m.attacks[m.index(occ)];
+}
+inline Bitboard queen_attacks(int sq, Bitboard occ) {
+    return bishop_attacks(sq, occ) | rook_attacks(sq, occ);
+}
+
+// Attacks of a non-pawn piece type from sq
+inline Bitboard piece_attacks(int pt, int sq, Bitboard occ) {
+    switch (pt) {
+        case PT_KNIGHT: return KNIGHT_ATTACKS[sq];
+        case PT_BISHOP: return bishop_attacks(sq, occ);
+        case PT_ROOK:   return rook_attacks(sq, occ);
+        case PT_QUEEN:  return queen_attacks(sq, occ);
+        case PT_KING:   return KING_ATTACKS[sq];
+    }
+    return 0;
+}
+
+// Squares in front of a pawn on its own and adjacent files; a pawn is
+// passed when no enemy pawn stands there
+extern Bitboard PASSED_PAWN_MASK[2][64];
+
+// ─── Line geometry ──────────────────────────────────────────
+// For squares sharing a rank, file or diagonal (0 otherwise):
+extern Bitboard BETWEEN_BB[64][64];    // Squares strictly between the two
+extern Bitboard LINE_BB[64][64];       // Whole line through both, inclusive
+
+void init_bitboards();
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
 
 // ─── Zobrist initialization ────────────────────────────────
 
@@ -31,6 +32,41 @@ void Board::init_zobrist() {
     z_init_done = true;
 }
 
+// ─── Cuckoo tables ─────────────────────────────────────────
+
+uint64_t Board::CUCKOO_KEY[8192];
+uint16_t Board::CUCKOO_MOVE[8192];
+bool Board::cuckoo_init_done = false;
+
+void Board::init_cuckoo() {
+    if (cuckoo_init_done) return;
+    init_zobrist();
+    init_bitboards();
+    memset(CUCKOO_KEY, 0, sizeof(CUCKOO_KEY));
+    memset(CUCKOO_MOVE, 0, sizeof(CUCKOO_MOVE));
+    for (int p = -W_KING; p <= W_KING; p++) {
+        int pt = std::abs(p);
+        if (pt == PT_NONE || pt == PT_PAWN) continue;
+        int pi = piece_index(p);
+        for (int s1 = 0; s1 < 64; s1++)
+            for (int s2 = s1 + 1; s2 < 64; s2++) {
+                if (!(piece_attacks(pt, s1, 0) & sq_bb(s2))) continue;
+                uint64_t key = Z_PIECE[pi][s1] ^ Z_PIECE[pi][s2] ^ Z_SIDE;
+                uint16_t mv = uint16_t(s1 | (s2 << 6));
+                // Cuckoo insertion: evict into the alternate slot until
+                // an empty one turns up
+                int i = cuckoo_h1(key);
+                while (true) {
+                    std::swap(CUCKOO_KEY[i], key);
+                    std::swap(CUCKOO_MOVE[i], mv);
+                    if (!key) break;
+                    i = (i == cuckoo_h1(key)) ? cuckoo_h2(key) : cuckoo_h1(key);
+                }
+            }
+    }
+    cuckoo_init_done = true;
+}
+
 void Board::compute_hash() {
     hash = 0;
     for (int sq = 0; sq < 64; sq++)
@@ -43,9 +79,15 @@ void Board::compute_hash() {
 // ─── Constructor ───────────────────────────────────────────
 
 Board::Board() : side(WHITE_SIDE), castling(0), ep_square(-1),
-                 halfmove(0), fullmove(1), hash(0), pos_history_count(0) {
+                 halfmove(0), fullmove(1), hash(0), pawn_hash(0), psq_mg(0), psq_eg(0), phase(0),
+                 pos_history_count(0) {
     init_zobrist();
+    init_bitboards();
+    init_psqt();
+    init_cuckoo();
     memset(board, 0, sizeof(board));
+    memset(pieces, 0, sizeof(pieces));
+    memset(colors, 0, sizeof(colors));
     king_sq[0] = king_sq[1] = -1;
     memset(pos_history, 0, sizeof(pos_history));
 }
@@ -54,6 +96,11 @@ Board::Board() : side(WHITE_SIDE), castling(0), ep_square(-1),
 
 void Board::set_fen(const std::string& fen) {
     memset(board, 0, sizeof(board));
+    memset(pieces, 0, sizeof(pieces));
+    memset(colors, 0, sizeof(colors));
+    pawn_hash = 0;
+    psq_mg = psq_eg = 0;
+    phase = 0;
     pos_history_count = 0;
     king_sq[0] = king_sq[1] = -1;
 
@@ -74,7 +121,7 @@ void Board::set_fen(const std::string& fen) {
             case 'b': p = -3; break; case 'r': p = -4; break;
             case 'q': p = -5; break; case 'k': p = -6; break;
         }
-        board[sq] = p;
+        if (p) put_piece(p, sq);
         if (p == W_KING) king_sq[WHITE_SIDE] = sq;
         if (p == B_KING) king_sq[BLACK_SIDE] = sq;
         sq++;
@@ -146,23 +193,19 @@ void Board::make_move(const Move& m, UndoInfo& undo) {
 
     // Remove piece from source
     hash ^= Z_PIECE[piece_index(piece)][m.from];
-    board[m.from] = 0;
+    remove_piece(m.from);
 
     // Remove captured piece
     if (m.captured) {
         int cap_sq = m.to;
-        if (m.flags & FL_EP) {
-            cap_sq = make_sq(sq_file(m.to), sq_rank(m.from));
-            hash ^= Z_PIECE[piece_index(m.captured)][cap_sq];
-            board[cap_sq] = 0;
-        } else {
-            hash ^= Z_PIECE[piece_index(m.captured)][m.to];
-        }
+        if (m.flags & FL_EP) cap_sq = make_sq(sq_file(m.to), sq_rank(m.from));
+        hash ^= Z_PIECE[piece_index(m.captured)][cap_sq];
+        remove_piece(cap_sq);
     }
 
     // Place piece (or promoted piece) on destination
     int placed = m.promotion ? m.promotion : piece;
-    board[m.to] = placed;
+    put_piece(placed, m.to);
     hash ^= Z_PIECE[piece_index(placed)][m.to];
 
     // Update king square
@@ -183,8 +226,8 @@ void Board::make_move(const Move& m, UndoInfo& undo) {
         }
         hash ^= Z_PIECE[piece_index(rook)][rook_from];
         hash ^= Z_PIECE[piece_index(rook)][rook_to];
-        board[rook_from] = 0;
-        board[rook_to] = rook;
+        remove_piece(rook_from);
+        put_piece(rook, rook_to);
     }
 
     // Update castling rights
@@ -220,8 +263,8 @@ void Board::make_move(const Move& m, UndoInfo& undo) {
     if (side == WHITE_SIDE) fullmove++;
 
     // Store position for repetition detection
-    if (pos_history_count < MAX_HISTORY)
-        pos_history[pos_history_count++] = hash;
+    undo.pushed = pos_history_count < MAX_HISTORY;
+    if (undo.pushed) pos_history[pos_history_count++] = hash;
 }
 
 void Board::unmake_move(const Move& m, const UndoInfo& undo) {
@@ -229,27 +272,24 @@ void Board::unmake_move(const Move& m, const UndoInfo& undo) {
     int piece = m.promotion ? (piece_sign(side) * PT_PAWN) : board[m.to];
     int pt = piece_type(piece);
 
-    board[m.to] = 0;
-    board[m.from] = piece;
+    remove_piece(m.to);
+    put_piece(piece, m.from);
 
     if (m.captured) {
-        if (m.flags & FL_EP) {
-            int cap_sq = make_sq(sq_file(m.to), sq_rank(m.from));
-            board[cap_sq] = m.captured;
-        } else {
-            board[m.to] = m.captured;
-        }
+        int cap_sq = m.to;
+        if (m.flags & FL_EP) cap_sq = make_sq(sq_file(m.to), sq_rank(m.from));
+        put_piece(m.captured, cap_sq);
     }
 
     // Undo castling rook
     if (m.flags & FL_CASTLE) {
         int rook = piece_sign(side) * PT_ROOK;
         if (sq_file(m.to) == 6) { // Kingside
-            board[make_sq(7, sq_rank(m.from))] = rook;
-            board[make_sq(5, sq_rank(m.from))] = 0;
+            remove_piece(make_sq(5, sq_rank(m.from)));
+            put_piece(rook, make_sq(7, sq_rank(m.from)));
         } else { // Queenside
-            board[make_sq(0, sq_rank(m.from))] = rook;
-            board[make_sq(3, sq_rank(m.from))] = 0;
+            remove_piece(make_sq(3, sq_rank(m.from)));
+            put_piece(rook, make_sq(0, sq_rank(m.from)));
         }
     }
 
@@ -261,7 +301,7 @@ void Board::unmake_move(const Move& m, const UndoInfo& undo) {
     hash = undo.hash;
     if (side == BLACK_SIDE) fullmove--;
 
-    if (pos_history_count > 0) pos_history_count--;
+    if (undo.pushed) pos_history_count--;
 }
 
 void Board::make_null_move(UndoInfo& undo) {
@@ -282,384 +322,423 @@ void Board::unmake_null_move(const UndoInfo& undo) {
 // ─── Attack detection ──────────────────────────────────────
 
 bool Board::is_attacked(int sq, int by_side) const {
-    int sign = piece_sign(by_side);
+    const Bitboard* bb = pieces[by_side];
 
-    // Pawn attacks
-    if (by_side == WHITE_SIDE) {
-        if (sq_rank(sq) > 0) {
-            if (sq_file(sq) > 0 && board[sq - 9] == W_PAWN) return true;
-            if (sq_file(sq) < 7 && board[sq - 7] == W_PAWN) return true;
-        }
-    } else {
-        if (sq_rank(sq) < 7) {
-            if (sq_file(sq) > 0 && board[sq + 7] == B_PAWN) return true;
-            if (sq_file(sq) < 7 && board[sq + 9] == B_PAWN) return true;
-        }
-    }
+    // Pawn, knight and king attacks: look from sq with the attacker's
+    // pattern (pawns use the defending side's capture direction)
+    if (PAWN_ATTACKS[by_side ^ 1][sq] & bb[PT_PAWN]) return true;
+    if (KNIGHT_ATTACKS[sq] & bb[PT_KNIGHT]) return true;
+    if (KING_ATTACKS[sq] & bb[PT_KING]) return true;
 
-    // Knight attacks
-    for (int d : KNIGHT_DIRS) {
-        int to = sq + d;
-        if (to >= 0 && to < 64 && abs(sq_file(to) - sq_file(sq)) <= 2 &&
-            board[to] == sign * PT_KNIGHT)
-            return true;
-    }
+    // Sliding attacks (magic lookups)
+    Bitboard occ = occupied();
+    if (bishop_attacks(sq, occ) & (bb[PT_BISHOP] | bb[PT_QUEEN])) return true;
+    if (rook_attacks(sq, occ) & (bb[PT_ROOK] | bb[PT_QUEEN])) return true;
+
+    return false;
+}
 
-    // King attacks
-    for (int d : KING_DIRS) {
-        int to = sq + d;
-        if (to >= 0 && to < 64 && abs(sq_file(to) - sq_file(sq)) <= 1 &&
-            board[to] == sign * PT_KING)
-            return true;
+Bitboard Board::attackers_to(int sq, Bitboard occ) const {
+    const Bitboard (*bb)[7] = pieces;
+    return (PAWN_ATTACKS[BLACK_SIDE][sq] & bb[WHITE_SIDE][PT_PAWN])
+         | (PAWN_ATTACKS[WHITE_SIDE][sq] & bb[BLACK_SIDE][PT_PAWN])
+         | (KNIGHT_ATTACKS[sq] & (bb[0][PT_KNIGHT] | bb[1][PT_KNIGHT]))
+         | (KING_ATTACKS[sq]   & (bb[0][PT_KING]   | bb[1][PT_KING]))
+         | (bishop_attacks(sq, occ) & (bb[0][PT_BISHOP] | bb[1][PT_BISHOP] |
+                                       bb[0][PT_QUEEN]  | bb[1][PT_QUEEN]))
+         | (rook_attacks(sq, occ)   & (bb[0][PT_ROOK]   | bb[1][PT_ROOK] |
+                                       bb[0][PT_QUEEN]  | bb[1][PT_QUEEN]));
+}
+
+Bitboard Board::pinned_pieces() const {
+    int them = side ^ 1;
+    int ksq = king_sq[side];
+    Bitboard occ = occupied();
+    Bitboard queens = pieces[them][PT_QUEEN];
+
+    // Enemy sliders that would hit the king on an empty board
+    Bitboard snipers = (rook_attacks(ksq, 0)   & (pieces[them][PT_ROOK]   | queens))
+                     | (bishop_attacks(ksq, 0) & (pieces[them][PT_BISHOP] | queens));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard between = BETWEEN_BB[ksq][pop_lsb(snipers)] & occ;
+        if (between && !more_than_one(between)) pinned |= between & colors[side];
     }
+    return pinned;
+}
 
-    // Sliding attacks (bishop/queen diagonals)
-    for (int d : BISHOP_DIRS) {
-        for (int to = sq + d; to >= 0 && to < 64; to += d) {
-            if (abs(sq_file(to) - sq_file(to - d)) != 1) break; // Wrapped
-            int p = board[to];
-            if (p == 0) continue;
-            if (p == sign * PT_BISHOP || p == sign * PT_QUEEN) return true;
-            break; // Blocked
-        }
+// ─── Static exchange evaluation ────────────────────────────
+
+// Material balance of the capture sequence on m.to, each side always
+// recapturing with its least valuable attacker and free to stop.
+// Sliders behind a capturer join in as x-rays; pins are ignored.
+int Board::see(const Move& m) const {
+    if (m.flags & FL_CASTLE) return 0;
+
+    int to = m.to;
+    int gain[32];
+    int d = 0;
+    int on_sq = piece_type(board[m.from]);   // Piece that would be captured next
+    gain[0] = PIECE_VAL[piece_type(m.captured)];
+    if (m.promotion) {
+        on_sq = piece_type(m.promotion);
+        gain[0] += PIECE_VAL[on_sq] - PIECE_VAL[PT_PAWN];
     }
 
-    // Sliding attacks (rook/queen straights)
-    for (int d : ROOK_DIRS) {
-        for (int to = sq + d; to >= 0 && to < 64; to += d) {
-            if (abs(d) == 1 && sq_rank(to) != sq_rank(to - d)) break; // File wrap
-            if (abs(d) == 8 && abs(sq_file(to) - sq_file(to - d)) != 0) break;
-            int p = board[to];
-            if (p == 0) continue;
-            if (p == sign * PT_ROOK || p == sign * PT_QUEEN) return true;
-            break;
-        }
+    Bitboard occ = occupied() ^ sq_bb(m.from);
+    if (m.flags & FL_EP) occ ^= sq_bb(make_sq(sq_file(to), sq_rank(m.from)));
+
+    Bitboard diag = pieces[0][PT_BISHOP] | pieces[1][PT_BISHOP] |
+                    pieces[0][PT_QUEEN]  | pieces[1][PT_QUEEN];
+    Bitboard orth = pieces[0][PT_ROOK]   | pieces[1][PT_ROOK] |
+                    pieces[0][PT_QUEEN]  | pieces[1][PT_QUEEN];
+    Bitboard attackers = attackers_to(to, occ) & occ;
+    int stm = side ^ 1;
+
+    while (true) {
+        Bitboard ours = attackers & colors[stm];
+        if (!ours) break;
+
+        int pt = PT_PAWN;
+        while (!(ours & pieces[stm][pt])) pt++;
+        // The king may only recapture onto an undefended square
+        if (pt == PT_KING && (attackers & colors[stm ^ 1])) break;
+
+        d++;
+        gain[d] = PIECE_VAL[on_sq] - gain[d - 1];
+
+        Bitboard b = ours & pieces[stm][pt];
+        occ ^= b & (0 - b);
+        if (pt == PT_PAWN || pt == PT_BISHOP || pt == PT_QUEEN)
+            attackers |= bishop_attacks(to, occ) & diag;
+        if (pt == PT_ROOK || pt == PT_QUEEN)
+            attackers |= rook_attacks(to, occ) & orth;
+        attackers &= occ;
+        on_sq = pt;
+        stm ^= 1;
     }
 
-    return false;
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+    return gain[0];
 }
 
 // ─── Move generation: Legal ────────────────────────────────
 
 int Board::gen_legal_moves(Move* moves) const {
-    Move pseudo[MAX_MOVES];
-    int n = gen_pseudo_moves(pseudo);
-    int legal = 0;
-
-    Board* self = const_cast<Board*>(this);
-    for (int i = 0; i < n; i++) {
-        UndoInfo undo;
-        self->make_move(pseudo[i], undo);
-        if (!is_attacked(king_sq[side ^ 1], side)) {
-            moves[legal++] = pseudo[i];
-        }
-        self->unmake_move(pseudo[i], undo);
-    }
-    return legal;
+    return gen_legal(moves, GEN_ALL);
 }
 
-bool Board::is_legal(const Move& m) {
-    UndoInfo undo;
-    make_move(m, undo);
-    bool legal = !is_attacked(king_sq[side ^ 1], side);
-    unmake_move(m, undo);
-    return legal;
+int Board::gen_captures(Move* moves) const {
+    return gen_legal(moves, GEN_CAPTURES);
 }
 
-// ─── Pseudo-legal move generation ──────────────────────────
-
-int Board::gen_pseudo_moves(Move* moves) const {
-    int count = 0;
-    gen_pawn_moves(moves, count);
-    gen_knight_moves(moves, count);
-    gen_slider_moves(moves, count, PT_BISHOP);
-    gen_slider_moves(moves, count, PT_ROOK);
-    gen_slider_moves(moves, count, PT_QUEEN);
-    gen_king_moves(moves, count);
-    return count;
+int Board::gen_quiets(Move* moves) const {
+    return gen_legal(moves, GEN_QUIETS);
 }
 
-int Board::gen_captures(Move* moves) const {
-    int count = 0;
-    gen_pawn_captures(moves, count);
-    gen_knight_captures(moves, count);
-    gen_slider_captures(moves, count, PT_BISHOP);
-    gen_slider_captures(moves, count, PT_ROOK);
-    gen_slider_captures(moves, count, PT_QUEEN);
-    gen_king_captures(moves, count);
-    return count;
+// Emits only legal moves: the checker set and pinned pieces are computed
+// once, in check only evasions are generated, and the king never steps
+// onto an attacked square. En passant is verified by is_legal because
+// removing two pawns from one rank can expose the king.
+int Board::gen_legal(Move* moves, GenType type) const {
+    int c = 0;
+    int ksq = king_sq[side];
+    Bitboard checkers = attackers_to(ksq, occupied()) & colors[side ^ 1];
+    Bitboard targets = type == GEN_CAPTURES ? colors[side ^ 1]
+                     : type == GEN_QUIETS   ? ~occupied()
+                     :                        ~colors[side];
+
+    // Double check: only the king can move
+    if (more_than_one(checkers)) {
+        gen_king_moves(moves, c, targets);
+        return c;
+    }
+
+    // Single check: capture the checker or block its ray
+    Bitboard mask = checkers ? (checkers | BETWEEN_BB[ksq][lsb(checkers)]) : ~0ULL;
+    Bitboard pinned = pinned_pieces();
+
+    gen_pawn_moves(moves, c, mask, pinned, type);
+    gen_piece_moves(moves, c, PT_KNIGHT, targets & mask, pinned);
+    gen_piece_moves(moves, c, PT_BISHOP, targets & mask, pinned);
+    gen_piece_moves(moves, c, PT_ROOK, targets & mask, pinned);
+    gen_piece_moves(moves, c, PT_QUEEN, targets & mask, pinned);
+    gen_king_moves(moves, c, targets);
+    if (!checkers && type != GEN_CAPTURES) gen_castling(moves, c);
+    return c;
 }
 
-// ─── Pawn moves ────────────────────────────────────────────
+// Whether m (with captured piece and flags filled in) could be generated
+// in this position, ignoring pins and checks
+bool Board::is_pseudo_legal(const Move& m) const {
+    int p = board[m.from];
+    if (p == 0 || piece_side(p) != side || m.from == m.to) return false;
+    if (board[m.to] && piece_side(board[m.to]) == side) return false;
+    if (piece_type(board[m.to]) == PT_KING) return false;
+
+    int pt = piece_type(p);
+    Bitboard to_bb = sq_bb(m.to);
+    Bitboard occ = occupied();
+
+    if (pt != PT_PAWN) {
+        if (m.promotion || (m.flags & (FL_EP | FL_DOUBLE))) return false;
+        if (m.captured != board[m.to]) return false;
+        if (m.flags & FL_CASTLE) {
+            if (pt != PT_KING) return false;
+            Move castles[2];
+            int n = 0;
+            gen_castling(castles, n);
+            for (int i = 0; i < n; i++)
+                if (castles[i] == m) return true;
+            return false;
+        }
+        return (piece_attacks(pt, m.from, occ) & to_bb) != 0;
+    }
 
-void Board::gen_pawn_moves(Move* moves, int& c) const {
-    int sign = piece_sign(side);
-    int pawn = sign * PT_PAWN;
+    // Pawns: promotion exactly when reaching the last rank
     int dir = (side == WHITE_SIDE) ? 8 : -8;
-    int start_rank = (side == WHITE_SIDE) ? 1 : 6;
     int promo_rank = (side == WHITE_SIDE) ? 7 : 0;
+    if ((sq_rank(m.to) == promo_rank) != (m.promotion != 0)) return false;
+    if (m.promotion && (piece_side(m.promotion) != side ||
+                        piece_type(m.promotion) < PT_KNIGHT ||
+                        piece_type(m.promotion) > PT_QUEEN)) return false;
+    if (m.flags & FL_CASTLE) return false;
+
+    if (m.flags & FL_EP)
+        return m.to == ep_square && (PAWN_ATTACKS[side][m.from] & to_bb) &&
+               m.captured == -piece_sign(side) * PT_PAWN;
+    if (m.captured != board[m.to]) return false;
+    if (m.captured)
+        return (PAWN_ATTACKS[side][m.from] & to_bb) && !(m.flags & FL_DOUBLE);
+    if (m.flags & FL_DOUBLE) {
+        int start_rank = (side == WHITE_SIDE) ? 1 : 6;
+        return sq_rank(m.from) == start_rank && m.to == m.from + 2 * dir &&
+               !(occ & (sq_bb(m.from + dir) | to_bb));
+    }
+    return m.to == m.from + dir && !(occ & to_bb);
+}
 
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != pawn) continue;
-        int f = sq_file(sq), r = sq_rank(sq);
+// Legality of a pseudo-legal move in the current position
+bool Board::is_legal(const Move& m) const {
+    int them = side ^ 1;
+    int ksq = king_sq[side];
+    Bitboard occ = occupied();
 
-        // Forward
-        int to = sq + dir;
-        if (to >= 0 && to < 64 && board[to] == 0) {
-            if (sq_rank(to) == promo_rank) {
-                moves[c++] = Move(sq, to, 0, sign * PT_QUEEN);
-                moves[c++] = Move(sq, to, 0, sign * PT_ROOK);
-                moves[c++] = Move(sq, to, 0, sign * PT_BISHOP);
-                moves[c++] = Move(sq, to, 0, sign * PT_KNIGHT);
-            } else {
-                moves[c++] = Move(sq, to);
-                // Double push
-                if (r == start_rank) {
-                    int to2 = sq + 2 * dir;
-                    if (board[to2] == 0)
-                        moves[c++] = Move(sq, to2, 0, 0, FL_DOUBLE);
-                }
-            }
-        }
+    if (m.flags & FL_EP) {
+        int cap_sq = make_sq(sq_file(m.to), sq_rank(m.from));
+        Bitboard after = (occ ^ sq_bb(m.from) ^ sq_bb(cap_sq)) | sq_bb(m.to);
+        return !(attackers_to(ksq, after) & colors[them] & ~sq_bb(cap_sq));
+    }
 
-        // Captures
-        int cap_dirs[2] = { dir - 1, dir + 1 };
-        int cap_files[2] = { f - 1, f + 1 };
-        for (int i = 0; i < 2; i++) {
-            if (cap_files[i] < 0 || cap_files[i] > 7) continue;
-            to = sq + cap_dirs[i];
-            if (to < 0 || to >= 64) continue;
-
-            if (board[to] != 0 && piece_side(board[to]) != (int)side) {
-                if (sq_rank(to) == promo_rank) {
-                    moves[c++] = Move(sq, to, board[to], sign * PT_QUEEN);
-                    moves[c++] = Move(sq, to, board[to], sign * PT_ROOK);
-                    moves[c++] = Move(sq, to, board[to], sign * PT_BISHOP);
-                    moves[c++] = Move(sq, to, board[to], sign * PT_KNIGHT);
-                } else {
-                    moves[c++] = Move(sq, to, board[to]);
-                }
-            }
-            // En passant
-            if (to == ep_square) {
-                int cap_pawn = -sign * PT_PAWN;
-                moves[c++] = Move(sq, to, cap_pawn, 0, FL_EP);
-            }
-        }
+    if (m.from == ksq) {
+        if (m.flags & FL_CASTLE)
+            return !is_attacked(ksq, them) &&
+                   !is_attacked((m.from + m.to) / 2, them) &&
+                   !is_attacked(m.to, them);
+        return !(attackers_to(m.to, occ ^ sq_bb(ksq)) & colors[them]);
     }
+
+    Bitboard checkers = attackers_to(ksq, occ) & colors[them];
+    if (checkers) {
+        if (more_than_one(checkers)) return false;
+        if (!((checkers | BETWEEN_BB[ksq][lsb(checkers)]) & sq_bb(m.to))) return false;
+    }
+    return !(pinned_pieces() & sq_bb(m.from)) || (LINE_BB[ksq][m.from] & sq_bb(m.to));
 }
 
-void Board::gen_pawn_captures(Move* moves, int& c) const {
+// ─── Pawn moves ────────────────────────────────────────────
+
+void Board::gen_pawn_moves(Move* moves, int& c, Bitboard mask, Bitboard pinned,
+                           GenType type) const {
+    bool captures = type != GEN_QUIETS;   // Captures and queen promotions
+    bool quiets = type != GEN_CAPTURES;   // Pushes and underpromotions
     int sign = piece_sign(side);
-    int pawn = sign * PT_PAWN;
     int dir = (side == WHITE_SIDE) ? 8 : -8;
+    int start_rank = (side == WHITE_SIDE) ? 1 : 6;
     int promo_rank = (side == WHITE_SIDE) ? 7 : 0;
+    int ksq = king_sq[side];
+    Bitboard occ = occupied();
+    Bitboard enemies = colors[side ^ 1];
 
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != pawn) continue;
-        int f = sq_file(sq);
-
-        // Promotion by pushing (treated as "capture" for quiescence)
-        int fwd = sq + dir;
-        if (fwd >= 0 && fwd < 64 && board[fwd] == 0 && sq_rank(fwd) == promo_rank) {
-            moves[c++] = Move(sq, fwd, 0, sign * PT_QUEEN);
-        }
-
-        int cap_dirs[2] = { dir - 1, dir + 1 };
-        int cap_files[2] = { f - 1, f + 1 };
-        for (int i = 0; i < 2; i++) {
-            if (cap_files[i] < 0 || cap_files[i] > 7) continue;
-            int to = sq + cap_dirs[i];
-            if (to < 0 || to >= 64) continue;
+    Bitboard pawns = pieces[side][PT_PAWN];
+    while (pawns) {
+        int sq = pop_lsb(pawns);
+        Bitboard allowed = mask;
+        if (pinned & sq_bb(sq)) allowed &= LINE_BB[ksq][sq];
 
-            if (board[to] != 0 && piece_side(board[to]) != (int)side) {
+        // Forward (queen promotions count as captures)
+        int to = sq + dir;
+        if (!(occ & sq_bb(to))) {
+            if (allowed & sq_bb(to)) {
                 if (sq_rank(to) == promo_rank) {
-                    moves[c++] = Move(sq, to, board[to], sign * PT_QUEEN);
-                } else {
-                    moves[c++] = Move(sq, to, board[to]);
+                    if (captures)
+                        moves[c++] = Move(sq, to, 0, sign * PT_QUEEN);
+                    if (quiets) {
+                        moves[c++] = Move(sq, to, 0, sign * PT_ROOK);
+                        moves[c++] = Move(sq, to, 0, sign * PT_BISHOP);
+                        moves[c++] = Move(sq, to, 0, sign * PT_KNIGHT);
+                    }
+                } else if (quiets) {
+                    moves[c++] = Move(sq, to);
                 }
             }
-            if (to == ep_square) {
-                moves[c++] = Move(sq, to, -sign * PT_PAWN, 0, FL_EP);
+            // Double push
+            if (quiets && sq_rank(sq) == start_rank) {
+                int to2 = sq + 2 * dir;
+                if (!(occ & sq_bb(to2)) && (allowed & sq_bb(to2)))
+                    moves[c++] = Move(sq, to2, 0, 0, FL_DOUBLE);
             }
         }
-    }
-}
 
-// ─── Knight moves ──────────────────────────────────────────
-
-void Board::gen_knight_moves(Move* moves, int& c) const {
-    int knight = piece_sign(side) * PT_KNIGHT;
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != knight) continue;
-        for (int d : KNIGHT_DIRS) {
-            int to = sq + d;
-            if (to < 0 || to >= 64) continue;
-            if (abs(sq_file(to) - sq_file(sq)) > 2) continue;
-            int target = board[to];
-            if (target == 0) {
-                moves[c++] = Move(sq, to);
-            } else if (piece_side(target) != (int)side) {
-                moves[c++] = Move(sq, to, target);
+        // Captures
+        Bitboard caps = PAWN_ATTACKS[side][sq] & enemies & allowed;
+        while (caps) {
+            to = pop_lsb(caps);
+            if (sq_rank(to) == promo_rank) {
+                if (captures)
+                    moves[c++] = Move(sq, to, board[to], sign * PT_QUEEN);
+                if (quiets) {
+                    moves[c++] = Move(sq, to, board[to], sign * PT_ROOK);
+                    moves[c++] = Move(sq, to, board[to], sign * PT_BISHOP);
+                    moves[c++] = Move(sq, to, board[to], sign * PT_KNIGHT);
+                }
+            } else if (captures) {
+                moves[c++] = Move(sq, to, board[to]);
             }
         }
-    }
-}
-
-void Board::gen_knight_captures(Move* moves, int& c) const {
-    int knight = piece_sign(side) * PT_KNIGHT;
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != knight) continue;
-        for (int d : KNIGHT_DIRS) {
-            int to = sq + d;
-            if (to < 0 || to >= 64) continue;
-            if (abs(sq_file(to) - sq_file(sq)) > 2) continue;
-            int target = board[to];
-            if (target != 0 && piece_side(target) != (int)side)
-                moves[c++] = Move(sq, to, target);
-        }
-    }
-}
-
-// ─── Sliding piece moves ──────────────────────────────────
 
-void Board::gen_slider_moves(Move* moves, int& c, int piece_t) const {
-    int sign = piece_sign(side);
-    int piece = sign * piece_t;
-    const int* dirs;
-    int ndirs;
-
-    if (piece_t == PT_BISHOP)      { dirs = BISHOP_DIRS; ndirs = 4; }
-    else if (piece_t == PT_ROOK)   { dirs = ROOK_DIRS;   ndirs = 4; }
-    else /* QUEEN */               { dirs = KING_DIRS;   ndirs = 8; }
-
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != piece) continue;
-        for (int di = 0; di < ndirs; di++) {
-            int d = dirs[di];
-            for (int to = sq + d; to >= 0 && to < 64; to += d) {
-                // Check for wrapping
-                int prev = to - d;
-                if (abs(sq_file(to) - sq_file(prev)) > 1) break;
-
-                int target = board[to];
-                if (target == 0) {
-                    moves[c++] = Move(sq, to);
-                } else {
-                    if (piece_side(target) != (int)side)
-                        moves[c++] = Move(sq, to, target);
-                    break;
-                }
-            }
+        // En passant
+        if (captures && ep_square >= 0 && (PAWN_ATTACKS[side][sq] & sq_bb(ep_square))) {
+            Move ep(sq, ep_square, -sign * PT_PAWN, 0, FL_EP);
+            if (is_legal(ep)) moves[c++] = ep;
         }
     }
 }
 
-void Board::gen_slider_captures(Move* moves, int& c, int piece_t) const {
-    int sign = piece_sign(side);
-    int piece = sign * piece_t;
-    const int* dirs;
-    int ndirs;
-
-    if (piece_t == PT_BISHOP)      { dirs = BISHOP_DIRS; ndirs = 4; }
-    else if (piece_t == PT_ROOK)   { dirs = ROOK_DIRS;   ndirs = 4; }
-    else                           { dirs = KING_DIRS;   ndirs = 8; }
-
-    for (int sq = 0; sq < 64; sq++) {
-        if (board[sq] != piece) continue;
-        for (int di = 0; di < ndirs; di++) {
-            int d = dirs[di];
-            for (int to = sq + d; to >= 0 && to < 64; to += d) {
-                int prev = to - d;
-                if (abs(sq_file(to) - sq_file(prev)) > 1) break;
-                int target = board[to];
-                if (target == 0) continue;
-                if (piece_side(target) != (int)side)
-                    moves[c++] = Move(sq, to, target);
-                break;
-            }
+// ─── Knight and slider moves ──────────────────────────────
+
+void Board::gen_piece_moves(Move* moves, int& c, int piece_t, Bitboard targets,
+                            Bitboard pinned) const {
+    int ksq = king_sq[side];
+    Bitboard occ = occupied();
+    Bitboard bb = pieces[side][piece_t];
+    while (bb) {
+        int sq = pop_lsb(bb);
+        Bitboard att = piece_attacks(piece_t, sq, occ) & targets;
+        if (pinned & sq_bb(sq)) att &= LINE_BB[ksq][sq]; // Stay on the pin ray
+        while (att) {
+            int to = pop_lsb(att);
+            moves[c++] = Move(sq, to, board[to]);
         }
     }
 }
 
 // ─── King moves ────────────────────────────────────────────
 
-void Board::gen_king_moves(Move* moves, int& c) const {
+void Board::gen_king_moves(Move* moves, int& c, Bitboard targets) const {
     int sq = king_sq[side];
-
-    for (int d : KING_DIRS) {
-        int to = sq + d;
-        if (to < 0 || to >= 64) continue;
-        if (abs(sq_file(to) - sq_file(sq)) > 1) continue;
-        int target = board[to];
-        if (target == 0) {
-            moves[c++] = Move(sq, to);
-        } else if (piece_side(target) != (int)side) {
-            moves[c++] = Move(sq, to, target);
-        }
-    }
-
-    // Castling
-    if (!is_attacked(sq, side ^ 1)) {
-        if (side == WHITE_SIDE) {
-            if ((castling & 1) && board[5] == 0 && board[6] == 0 &&
-                !is_attacked(5, BLACK_SIDE) && !is_attacked(6, BLACK_SIDE))
-                moves[c++] = Move(4, 6, 0, 0, FL_CASTLE);
-            if ((castling & 2) && board[3] == 0 && board[2] == 0 && board[1] == 0 &&
-                !is_attacked(3, BLACK_SIDE) && !is_attacked(2, BLACK_SIDE))
-                moves[c++] = Move(4, 2, 0, 0, FL_CASTLE);
-        } else {
-            if ((castling & 4) && board[61] == 0 && board[62] == 0 &&
-                !is_attacked(61, WHITE_SIDE) && !is_attacked(62, WHITE_SIDE))
-                moves[c++] = Move(60, 62, 0, 0, FL_CASTLE);
-            if ((castling & 8) && board[59] == 0 && board[58] == 0 && board[57] == 0 &&
-                !is_attacked(59, WHITE_SIDE) && !is_attacked(58, WHITE_SIDE))
-                moves[c++] = Move(60, 58, 0, 0, FL_CASTLE);
-        }
+    // Lift the king so sliders see through its current square
+    Bitboard occ = occupied() ^ sq_bb(sq);
+    Bitboard att = KING_ATTACKS[sq] & targets;
+    while (att) {
+        int to = pop_lsb(att);
+        if (!(attackers_to(to, occ) & colors[side ^ 1]))
+            moves[c++] = Move(sq, to, board[to]);
     }
 }
 
-void Board::gen_king_captures(Move* moves, int& c) const {
+void Board::gen_castling(Move* moves, int& c) const {
     int sq = king_sq[side];
-    for (int d : KING_DIRS) {
-        int to = sq + d;
-        if (to < 0 || to >= 64) continue;
-        if (abs(sq_file(to) - sq_file(sq)) > 1) continue;
-        int target = board[to];
-        if (target != 0 && piece_side(target) != (int)side)
-            moves[c++] = Move(sq, to, target);
+    if (is_attacked(sq, side ^ 1)) return;
+
+    if (side == WHITE_SIDE) {
+        if ((castling & 1) && board[5] == 0 && board[6] == 0 &&
+            !is_attacked(5, BLACK_SIDE) && !is_attacked(6, BLACK_SIDE))
+            moves[c++] = Move(4, 6, 0, 0, FL_CASTLE);
+        if ((castling & 2) && board[3] == 0 && board[2] == 0 && board[1] == 0 &&
+            !is_attacked(3, BLACK_SIDE) && !is_attacked(2, BLACK_SIDE))
+            moves[c++] = Move(4, 2, 0, 0, FL_CASTLE);
+    } else {
+        if ((castling & 4) && board[61] == 0 && board[62] == 0 &&
+            !is_attacked(61, WHITE_SIDE) && !is_attacked(62, WHITE_SIDE))
+            moves[c++] = Move(60, 62, 0, 0, FL_CASTLE);
+        if ((castling & 8) && board[59] == 0 && board[58] == 0 && board[57] == 0 &&
+            !is_attacked(59, WHITE_SIDE) && !is_attacked(58, WHITE_SIDE))
+            moves[c++] = Move(60, 58, 0, 0, FL_CASTLE);
     }
 }
 
 // ─── Draw detection ────────────────────────────────────────
 
-int Board::count_repetitions() const {
-    int count = 0;
-    for (int i = pos_history_count - 3; i >= 0; i -= 2) {
-        if (pos_history[i] == hash) count++;
-    }
-    return count;
+void Board::reset_history() {
+    pos_history[0] = hash;
+    pos_history_count = 1;
 }
 
-bool Board::is_draw() const {
+// 50-move rule or repetition. Only the last `halfmove` plies can repeat
+// the current position. A repetition inside the search (at most `ply`
+// plies back) is scored as a draw at once; older ones need the third
+// occurrence, as in the game.
+bool Board::is_draw(int ply) const {
     if (halfmove >= 100) return true;
-    if (count_repetitions() >= 2) return true; // 3-fold
+    int end = std::max(0, pos_history_count - 1 - halfmove);
+    int reps = 0;
+    for (int i = pos_history_count - 3, d = 2; i >= end; i -= 2, d += 2) {
+        if (pos_history[i] != hash) continue;
+        if (d <= ply || ++reps >= 2) return true;
+    }
+    return false;
+}
+
+// True if the side to move has a reversible move that reaches a position
+// already in the history, i.e. it can force at least a repetition draw.
+// Each earlier position with the other side to move differs from the
+// current one by a single piece move exactly when the key difference is
+// in the cuckoo table and that move's path is clear.
+bool Board::has_game_cycle(int ply) const {
+    int end = std::min(halfmove, pos_history_count - 1);
+    if (end < 3) return false;
+
+    for (int i = 3; i <= end; i += 2) {
+        int idx = pos_history_count - 1 - i;
+        uint64_t move_key = hash ^ pos_history[idx];
+        int j = cuckoo_h1(move_key);
+        if (CUCKOO_KEY[j] != move_key) {
+            j = cuckoo_h2(move_key);
+            if (CUCKOO_KEY[j] != move_key) continue;
+        }
+        int s1 = CUCKOO_MOVE[j] & 63, s2 = CUCKOO_MOVE[j] >> 6;
+        if (BETWEEN_BB[s1][s2] & occupied()) continue;
+
+        if (ply > i) return true;
+
+        // At or before the root the cycle must be a real repetition: the
+        // move has to belong to the side to move (the table stores both
+        // directions in one slot), and the target position must itself
+        // have occurred before
+        int p = board[s1] ? board[s1] : board[s2];
+        if ((p > 0 ? WHITE_SIDE : BLACK_SIDE) != side) continue;
+        int first = pos_history_count - 1 - end;
+        for (int k = idx - 2; k >= first; k -= 2)
+            if (pos_history[k] == pos_history[idx]) return true;
+    }
     return false;
 }
 
 // ─── Move::from_uci ────────────────────────────────────────
 
 Move Move::from_uci(const std::string& s, const int* bd) {
+    // Malformed tokens (short, or squares off the board) give a null move
     if (s.size() < 4) return Move();
+    for (int i = 0; i < 4; i += 2)
+        if (s[i] < 'a' || s[i] > 'h' || s[i + 1] < '1' || s[i + 1] > '8') return Move();
     int from = make_sq(s[0] - 'a', s[1] - '1');
     int to   = make_sq(s[2] - 'a', s[3] - '1');
-    int cap  = bd[to];
+    int sign = bd[from] > 0 ? 1 : -1;
     int promo = 0;
-    int flags = 0;
-
-    int piece = bd[from];
-    int pt = piece_type(piece);
-    int sign = piece > 0 ? 1 : -1;
 
     // Promotion
     if (s.size() == 5) {
@@ -670,6 +749,16 @@ Move Move::from_uci(const std::string& s, const int* bd) {
             case 'n': promo = sign * PT_KNIGHT; break;
         }
     }
+    return from_squares(from, to, promo, bd);
+}
+
+Move Move::from_squares(int from, int to, int promo, const int* bd) {
+    int cap  = bd[to];
+    int flags = 0;
+
+    int piece = bd[from];
+    int pt = piece_type(piece);
+    int sign = piece > 0 ? 1 : -1;
 
     // En passant
     if (pt == PT_PAWN && sq_file(from) != sq_file(to) && cap == 0) {
@@ -3,11 +3,20 @@
 // board.h — Board state, move generation, attack detection
 // ============================================================
 
-#include "types.h"
+#include "bitboard.h"
+#include "psqt.h"
 #include <array>
 #include <vector>
 #include <string>
 
+// Which legal moves a generator call emits. Captures and quiets are
+// disjoint and together make up GEN_ALL.
+enum GenType {
+    GEN_ALL,
+    GEN_CAPTURES,   // Captures (incl. en passant) + queen promotions
+    GEN_QUIETS      // Non-captures, underpromotions, castling
+};
+
 class Board {
 public:
     int board[64];            // Piece at each square (signed: +white, -black)
@@ -17,9 +26,20 @@ public:
     int halfmove;             // Half-move clock (for 50-move rule)
     int fullmove;
     uint64_t hash;            // Zobrist hash
+    uint64_t pawn_hash;       // Zobrist hash of pawns only (pawn eval cache key)
 
     int king_sq[2];           // King square per side
 
+    // ─── Bitboards (kept in sync with board[]) ──────────────
+    Bitboard pieces[2][7];    // [side][piece type] occupancy (index 0 unused)
+    Bitboard colors[2];       // All pieces per side
+    Bitboard occupied() const { return colors[WHITE_SIDE] | colors[BLACK_SIDE]; }
+
+    // ─── Incremental evaluation ─────────────────────────────
+    int psq_mg, psq_eg;       // Material + PST sums (White-positive); piece
+                              // counts come from popcount(pieces[s][pt])
+    int phase;                // Sum of PHASE_INC over pieces on the board
+
     // ─── Zobrist ────────────────────────────────────────────
     static uint64_t Z_PIECE[13][64];  // [piece_index][square]
     static uint64_t Z_SIDE;
@@ -27,6 +47,16 @@ public:
     static uint64_t Z_EP[8];          // per file
     static bool z_init_done;
     static void init_zobrist();
+
+    // Cuckoo tables of reversible moves for upcoming-repetition detection:
+    // each key is Z_PIECE[p][s1] ^ Z_PIECE[p][s2] ^ Z_SIDE for a non-pawn
+    // piece that can move between s1 and s2 on an empty board
+    static uint64_t CUCKOO_KEY[8192];
+    static uint16_t CUCKOO_MOVE[8192];  // from | to << 6
+    static bool cuckoo_init_done;
+    static void init_cuckoo();
+    static int cuckoo_h1(uint64_t k) { return int(k & 0x1FFF); }
+    static int cuckoo_h2(uint64_t k) { return int((k >> 16) & 0x1FFF); }
     static int piece_index(int p) {   // Maps signed piece to 0-12
         if (p > 0) return p;          // 1-6 = white P,N,B,R,Q,K
         if (p < 0) return 6 + (-p);   // 7-12 = black P,N,B,R,Q,K
@@ -46,29 +76,57 @@ public:
 
     // ─── Move generation ────────────────────────────────────
     int gen_legal_moves(Move* moves) const;
-    int gen_pseudo_moves(Move* moves) const;
-    int gen_captures(Move* moves) const;
-    bool is_legal(const Move& m);
+    int gen_captures(Move* moves) const;      // Legal captures + queen promotions
+    int gen_quiets(Move* moves) const;        // Legal remainder of gen_legal_moves
+    bool is_pseudo_legal(const Move& m) const; // e.g. TT / killer moves
+    bool is_legal(const Move& m) const;       // m must be pseudo-legal
 
     // ─── Attack detection ───────────────────────────────────
     bool is_attacked(int sq, int by_side) const;
+    Bitboard attackers_to(int sq, Bitboard occ) const;  // Both sides
+    Bitboard pinned_pieces() const;           // Side to move's pinned pieces
     bool in_check() const { return is_attacked(king_sq[side], side ^ 1); }
+    int see(const Move& m) const;             // Static exchange gain of m
 
     // ─── Utilities ──────────────────────────────────────────
     void compute_hash();
-    bool is_draw() const;
-    int count_repetitions() const;
+    bool is_draw(int ply = 0) const;           // ply = distance from the search root
+    void reset_history();                     // Forget all but the current position
+    bool has_game_cycle(int ply) const;       // A reversible move repeats a position
 
 private:
-    void gen_pawn_moves(Move* moves, int& count) const;
-    void gen_knight_moves(Move* moves, int& count) const;
-    void gen_slider_moves(Move* moves, int& count, int piece_t) const;
-    void gen_king_moves(Move* moves, int& count) const;
-
-    void gen_pawn_captures(Move* moves, int& count) const;
-    void gen_knight_captures(Move* moves, int& count) const;
-    void gen_slider_captures(Move* moves, int& count, int piece_t) const;
-    void gen_king_captures(Move* moves, int& count) const;
+    // ─── Piece placement (updates board[] and bitboards) ────
+    void put_piece(int p, int sq) {
+        Bitboard b = sq_bb(sq);
+        board[sq] = p;
+        pieces[piece_side(p)][piece_type(p)] |= b;
+        colors[piece_side(p)] |= b;
+        if (piece_type(p) == PT_PAWN) pawn_hash ^= Z_PIECE[piece_index(p)][sq];
+        psq_mg += PSQ_MG[piece_index(p)][sq];
+        psq_eg += PSQ_EG[piece_index(p)][sq];
+        phase  += PHASE_INC[piece_type(p)];
+    }
+    void remove_piece(int sq) {
+        int p = board[sq];
+        Bitboard b = sq_bb(sq);
+        board[sq] = 0;
+        pieces[piece_side(p)][piece_type(p)] ^= b;
+        colors[piece_side(p)] ^= b;
+        if (piece_type(p) == PT_PAWN) pawn_hash ^= Z_PIECE[piece_index(p)][sq];
+        psq_mg -= PSQ_MG[piece_index(p)][sq];
+        psq_eg -= PSQ_EG[piece_index(p)][sq];
+        phase  -= PHASE_INC[piece_type(p)];
+    }
+
+    // Legal generators: destinations are limited to 'targets' / 'mask'
+    // (check evasion squares) and pinned pieces stay on their pin ray
+    int gen_legal(Move* moves, GenType type) const;
+    void gen_pawn_moves(Move* moves, int& count, Bitboard mask, Bitboard pinned,
+                        GenType type) const;
+    void gen_piece_moves(Move* moves, int& count, int piece_t, Bitboard targets,
+                         Bitboard pinned) const;
+    void gen_king_moves(Move* moves, int& count, Bitboard targets) const;
+    void gen_castling(Move* moves, int& count) const;
 
     // Position history for repetition detection
     static constexpr int MAX_HISTORY = 1024;
@@ -2,39 +2,311 @@
 // main.cpp — Command-line interface for the chess engine
 //
 // Protocol (one position per line):
-//   Input:  <FEN> | <max_depth> | <movetime_ms>
-//   Output: bestmove <uci> depth <d> eval <cp> nodes <n> time <ms> tt_hits <h> tt_stores <s>
+//   Input:  <position> | <max_depth> | <movetime_ms>
+//           where <position> is <FEN> or startpos, optionally followed by
+//           "moves <uci> ..." — moves are replayed so that repetitions of
+//           earlier game positions are seen by the search
+//   Output: one line per completed iteration while searching
+//             info depth <d> seldepth <d> score cp <cp>|mate <n> nodes <n>
+//                  nps <n> hashfull <permille> tthitrate <permille>
+//                  time <ms> pv <moves>
+//           then
+//             bestmove <uci> depth <d> eval <cp> nodes <n> time <ms> tt_hits <h> tt_stores <s>
+//                      pv <moves>
 //
 // Special commands:
-//   quit       — exit
-//   ping       — respond with "pong"
+//   quit                     — exit
+//   ping                     — respond with "pong"
+//   newgame                  — reset move-ordering tables (TT is aged, not cleared)
+//   threads <n>              — search with n threads (Lazy SMP, shared TT)
+//   perft [opts] <d> [FEN]   — move generation node count, time and nps
+//   divide [opts] <d> [FEN]  — perft with per-move subtotals
+//   perftsuite [opts]        — run the reference perft positions
+//   (opts: "bulk" counts leaf moves without making them,
+//          "hash <mb>" caches subtree counts)
+//   uci                      — switch to the UCI protocol for the session
+//
+// UCI: uci, isready, ucinewgame, setoption (Hash, Threads),
+//   position startpos|fen <FEN> [moves ...], go [wtime btime winc binc
+//   movestogo depth nodes movetime infinite ponder], stop, ponderhit,
+//   quit. Searches run on a worker thread, so stop/ponderhit/isready are
+//   handled while the engine thinks.
 // ============================================================
 
 #include "search.h"
+#include "perft.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+static const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Handles the perft, divide and perftsuite commands
+static void run_perft(const std::string& line) {
+    std::istringstream ss(line);
+    std::string cmd, fen;
+    ss >> cmd;
+    PerftOptions opt;
+    int depth = 0;
+    parse_perft_args(ss, opt, depth, fen);
+
+    if (cmd == "perftsuite") { perft_suite(opt, std::cout); return; }
+
+    Board board;
+    board.set_fen(fen.empty() ? START_FEN : fen);
+    if (cmd == "divide") perft_divide(board, depth, opt, std::cout);
+    else                 perft_report(board, depth, opt, std::cout);
+}
+
+// Sets up fen and plays the UCI moves that follow in 'moves' (up to the
+// first illegal one). Replaying them through make_move records the game
+// history, so the search can see repetitions of earlier positions; only
+// the plies since the last capture or pawn move are kept.
+static void set_position(Board& board, const std::string& fen, std::istream& moves) {
+    board.set_fen(fen);
+    std::string token;
+    while (moves >> token) {
+        Move m = Move::from_uci(token, board.board);
+        Move legal[MAX_MOVES];
+        int n = board.gen_legal_moves(legal);
+        if (std::find(legal, legal + n, m) == legal + n) break;
+        UndoInfo undo;
+        board.make_move(m, undo);
+        if (board.halfmove == 0) board.reset_history();
+    }
+}
+
+// ─── UCI ───────────────────────────────────────────────────
+
+static std::mutex out_mutex;   // Worker and input threads both print
+
+static void send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(out_mutex);
+    std::cout << line << std::endl;
+}
+
+// "info" line for one iteration; UCI has no field for the TT hit rate
+static std::string format_info(const SearchInfo& info, bool uci) {
+    std::ostringstream ss;
+    ss << "info depth " << info.depth << " seldepth " << info.seldepth << " score ";
+    if (std::abs(info.score) >= MATE_IN_MAX_PLY) {
+        int plies = MATE_SCORE - std::abs(info.score);
+        ss << "mate " << (info.score > 0 ? (plies + 1) / 2 : -(plies / 2));
+    } else {
+        ss << "cp " << info.score;
+    }
+    ss << " nodes " << info.nodes << " nps " << info.nps
+       << " hashfull " << info.hashfull;
+    if (!uci) ss << " tthitrate " << info.tt_hit_rate;
+    ss << " time " << info.time_ms << " pv";
+    for (const Move& m : info.pv) ss << ' ' << m.uci();
+    return ss.str();
+}
+
+struct UciState {
+    Board board;                   // Set by "position"
+    std::thread worker;
+    std::atomic<bool> stop{false}; // Polled by the search
+    std::mutex mutex;              // Guards the ponder state; pairs with cv
+    std::condition_variable cv;
+    bool pondering = false;
+    bool started = false;          // Search limits in force; ponderhit can apply
+    bool ponderhit_pending = false; // Arrived before the search started
+    int ponder_time = 0;           // Move time to use after ponderhit
+};
+
+// Share of the remaining clock for this move, keeping a safety margin
+static int allot_time(int time_left, int inc, int movestogo) {
+    int mtg = movestogo > 0 ? std::min(movestogo, 40) : 30;
+    int t = time_left / mtg + inc * 3 / 4;
+    return std::max(1, std::min(t, time_left - 50));
+}
+
+// Stops a running search (its bestmove is still printed) and waits for it
+static void finish_search(UciState& st) {
+    if (!st.worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.stop = true;
+    }
+    st.cv.notify_all();
+    st.worker.join();
+}
+
+static void uci_position(UciState& st, std::istringstream& ss) {
+    std::string token, fen;
+    ss >> token;
+    if (token == "startpos") {
+        fen = START_FEN;
+        ss >> token;   // "moves", if any
+    } else if (token == "fen") {
+        while (ss >> token && token != "moves") fen += token + " ";
+    } else {
+        return;
+    }
+    set_position(st.board, fen, ss);
+}
+
+static void uci_go(UciState& st, Searcher& searcher, std::istringstream& ss) {
+    finish_search(st);
+
+    SearchLimits limits;
+    int time[2] = {0, 0}, inc[2] = {0, 0}, movestogo = 0;
+    bool infinite = false, ponder = false;
+    std::string token;
+    while (ss >> token) {
+        if      (token == "wtime")     ss >> time[WHITE_SIDE];
+        else if (token == "btime")     ss >> time[BLACK_SIDE];
+        else if (token == "winc")      ss >> inc[WHITE_SIDE];
+        else if (token == "binc")      ss >> inc[BLACK_SIDE];
+        else if (token == "movestogo") ss >> movestogo;
+        else if (token == "depth")     ss >> limits.depth;
+        else if (token == "nodes")     ss >> limits.nodes;
+        else if (token == "movetime")  ss >> limits.movetime;
+        else if (token == "infinite")  infinite = true;
+        else if (token == "ponder")    ponder = true;
+    }
+
+    int us = st.board.side;
+    if (!limits.movetime && time[us] > 0)
+        limits.movetime = allot_time(time[us], inc[us], movestogo);
+    st.ponder_time = limits.movetime;
+    if (infinite || ponder) limits.movetime = 0;
+
+    st.stop = false;
+    st.pondering = ponder;
+    st.started = st.ponderhit_pending = false;
+    limits.stop = &st.stop;
+    // A ponderhit that beat the search to its start is applied here, so
+    // search() cannot overwrite the new deadline with its own limits
+    limits.started = [&st, &searcher] {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        st.started = true;
+        if (st.ponderhit_pending && st.ponder_time > 0) searcher.ponderhit(st.ponder_time);
+    };
+
+    Board board = st.board;
+    st.worker = std::thread([&st, &searcher, board, limits, infinite]() mutable {
+        SearchResult result = searcher.search(board, limits);
+
+        // No bestmove before "stop" (infinite) or "ponderhit" (ponder)
+        {
+            std::unique_lock<std::mutex> lock(st.mutex);
+            st.cv.wait(lock, [&] { return st.stop || (!infinite && !st.pondering); });
+        }
+        std::string line = "bestmove " + (result.best_move.is_null() ? std::string("0000")
+                                                                     : result.best_move.uci());
+        if (result.pv.size() >= 2) line += " ponder " + result.pv[1].uci();
+        send(line);
+    });
+}
+
+static void uci_setoption(UciState& st, Searcher& searcher, std::istringstream& ss) {
+    std::string token, name, value;
+    ss >> token;   // "name"
+    while (ss >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+    ss >> value;
+
+    finish_search(st);
+    try {
+        if (name == "Hash")    searcher.set_hash(std::max(1, std::stoi(value)));
+        if (name == "Threads") searcher.set_threads(std::max(1, std::stoi(value)));
+    } catch (...) {}
+}
+
+static void uci_loop(Searcher& searcher) {
+    UciState st;
+    st.board.set_fen(START_FEN);
+    searcher.set_info_callback([](const SearchInfo& info) { send(format_info(info, true)); });
+    std::string line = "uci";
+
+    do {
+        std::istringstream ss(line);
+        std::string cmd;
+        ss >> cmd;
+
+        if (cmd == "uci") {
+            send("id name Chess Engine");
+            send("id author Chess Engine contributors");
+            send("option name Hash type spin default 64 min 1 max 4096");
+            send("option name Threads type spin default 1 min 1 max 64");
+            send("option name Ponder type check default false");
+            send("uciok");
+        } else if (cmd == "isready") {
+            send("readyok");
+        } else if (cmd == "ucinewgame") {
+            finish_search(st);
+            searcher.new_game();
+        } else if (cmd == "setoption") {
+            uci_setoption(st, searcher, ss);
+        } else if (cmd == "position") {
+            uci_position(st, ss);
+        } else if (cmd == "go") {
+            uci_go(st, searcher, ss);
+        } else if (cmd == "stop") {
+            finish_search(st);
+        } else if (cmd == "ponderhit") {
+            {
+                std::lock_guard<std::mutex> lock(st.mutex);
+                st.pondering = false;
+                if (!st.started)             st.ponderhit_pending = true;
+                else if (st.ponder_time > 0) searcher.ponderhit(st.ponder_time);
+            }
+            st.cv.notify_all();
+        } else if (cmd == "quit") {
+            break;
+        }
+    } while (std::getline(std::cin, line));
+
+    finish_search(st);
+}
 
 int main() {
     Board::init_zobrist();
+    init_bitboards();
+    init_psqt();
+    Board::init_cuckoo();
     Searcher searcher(64); // 64 MB transposition table
+    searcher.set_info_callback([](const SearchInfo& info) { send(format_info(info, false)); });
 
     std::string line;
     while (std::getline(std::cin, line)) {
         if (line == "quit") break;
+        if (line == "uci") {
+            uci_loop(searcher);
+            break;
+        }
         if (line == "ping") {
             std::cout << "pong" << std::endl;
             continue;
         }
+        if (line == "newgame") {
+            searcher.new_game();
+            continue;
+        }
+        if (line.compare(0, 8, "threads ") == 0) {
+            try { searcher.set_threads(std::max(1, std::stoi(line.substr(8)))); } catch (...) {}
+            continue;
+        }
+        if (line.compare(0, 5, "perft") == 0 || line.compare(0, 6, "divide") == 0) {
+            run_perft(line);
+            continue;
+        }
 
-        // Parse: FEN | max_depth | movetime_ms
+        // Parse: position | max_depth | movetime_ms
         auto sep1 = line.find('|');
         if (sep1 == std::string::npos) continue;
 
-        std::string fen = line.substr(0, sep1);
-        // Trim whitespace
-        while (!fen.empty() && fen.back() == ' ') fen.pop_back();
-        while (!fen.empty() && fen.front() == ' ') fen.erase(fen.begin());
+        // FEN (or startpos) up to an optional "moves" list
+        std::istringstream pos(line.substr(0, sep1));
+        std::string fen, token;
+        while (pos >> token && token != "moves") fen += token + " ";
+        if (fen == "startpos ") fen = START_FEN;
 
         int max_depth = 0;   // 0 = unlimited (time controls)
         int movetime = 120000; // default 120 seconds safety
@@ -51,7 +323,7 @@ int main() {
         }
 
         Board board;
-        board.set_fen(fen);
+        set_position(board, fen, pos);
 
         SearchResult result = searcher.search(board, max_depth, movetime);
 
@@ -63,7 +335,9 @@ int main() {
                   << " time " << result.time_ms
                   << " tt_hits " << result.tt_hits
                   << " tt_stores " << result.tt_stores
-                  << std::endl;
+                  << " pv";
+        for (const Move& m : result.pv) std::cout << ' ' << m.uci();
+        std::cout << std::endl;
     }
 
     return 0;
@@ -0,0 +1,104 @@
+// ============================================================
+// movepick.cpp — Staged move picker
+// ============================================================
+
+#include "movepick.h"
+#include <utility>
+
+MovePicker::MovePicker(const Board& b, const Move& tt, const Move* k,
+                       const int (*h)[64])
+    : board(b), killers(k), history(h), stage(STAGE_TT), killer_idx(0),
+      count(0), cur(0), end_bad(0) {
+    // TT moves are stored as from/to/promotion only; rebuild and verify
+    if (!tt.is_null()) {
+        Move m = Move::from_squares(tt.from, tt.to, tt.promotion, board.board);
+        if (board.is_pseudo_legal(m) && board.is_legal(m)) tt_move = m;
+    }
+}
+
+bool MovePicker::is_emitted(const Move& m) const {
+    return (!tt_move.is_null() && m == tt_move) ||
+           (!killer_moves[0].is_null() && m == killer_moves[0]) ||
+           (!killer_moves[1].is_null() && m == killer_moves[1]);
+}
+
+// Selection of the best remaining move — only as much sorting as is used
+bool MovePicker::pick_best(Move& m) {
+    while (cur < count) {
+        int best = cur;
+        for (int i = cur + 1; i < count; i++)
+            if (scores[i] > scores[best]) best = i;
+        std::swap(moves[cur], moves[best]);
+        std::swap(scores[cur], scores[best]);
+        m = moves[cur++];
+        if (!is_emitted(m)) return true;
+    }
+    return false;
+}
+
+bool MovePicker::next(Move& m) {
+    switch (stage) {
+    case STAGE_TT:
+        stage = STAGE_CAPTURES_INIT;
+        if (!tt_move.is_null()) { m = tt_move; return true; }
+        [[fallthrough]];
+
+    case STAGE_CAPTURES_INIT:
+        // MVV-LVA; queen promotions rank with the captures. SEE is only
+        // paid for the captures actually reached.
+        count = board.gen_captures(moves);
+        cur = 0;
+        for (int i = 0; i < count; i++) {
+            int victim = PIECE_VAL[piece_type(moves[i].captured)];
+            int attacker = PIECE_VAL[piece_type(board.board[moves[i].from])];
+            scores[i] = victim * 10 - attacker;
+            if (moves[i].promotion) scores[i] += PIECE_VAL[PT_QUEEN];
+        }
+        stage = STAGE_CAPTURES;
+        [[fallthrough]];
+
+    case STAGE_CAPTURES:
+        while (pick_best(m)) {
+            if (board.see(m) < 0) { moves[end_bad++] = m; continue; }
+            return true;
+        }
+        stage = STAGE_KILLERS;
+        [[fallthrough]];
+
+    case STAGE_KILLERS:
+        while (killers && killer_idx < 2) {
+            const Move& k = killers[killer_idx++];
+            if (k.is_null() || k == tt_move || board.board[k.to] != 0) continue;
+            if (board.is_pseudo_legal(k) && board.is_legal(k)) {
+                killer_moves[killer_idx - 1] = k;
+                m = k;
+                return true;
+            }
+        }
+        stage = STAGE_QUIETS_INIT;
+        [[fallthrough]];
+
+    case STAGE_QUIETS_INIT:
+        cur = count;
+        count += board.gen_quiets(moves + count);
+        for (int i = cur; i < count; i++)
+            scores[i] = history[moves[i].from][moves[i].to];
+        stage = STAGE_QUIETS;
+        [[fallthrough]];
+
+    case STAGE_QUIETS:
+        if (pick_best(m)) return true;
+        cur = 0;
+        stage = STAGE_BAD_CAPTURES;
+        [[fallthrough]];
+
+    case STAGE_BAD_CAPTURES:
+        // Already in MVV-LVA order
+        if (cur < end_bad) { m = moves[cur++]; return true; }
+        stage = STAGE_DONE;
+        [[fallthrough]];
+
+    default:
+        return false;
+    }
+}
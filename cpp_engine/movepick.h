@@ -0,0 +1,49 @@
+#pragma once
+// ============================================================
+// movepick.h — Staged move picker for the main search
+// ============================================================
+
+#include "board.h"
+
+// Moves are produced one stage at a time so that a node which fails
+// high on the TT move or an early capture never generates quiets.
+enum PickStage {
+    STAGE_TT,
+    STAGE_CAPTURES_INIT,
+    STAGE_CAPTURES,
+    STAGE_KILLERS,
+    STAGE_QUIETS_INIT,
+    STAGE_QUIETS,
+    STAGE_BAD_CAPTURES,
+    STAGE_DONE
+};
+
+class MovePicker {
+public:
+    // killers: the two killer slots for this ply (or nullptr);
+    // history: the side to move's [from][to] history table
+    MovePicker(const Board& board, const Move& tt_move,
+               const Move* killers, const int (*history)[64]);
+
+    // Next legal move in stage order; false when exhausted
+    bool next(Move& m);
+
+private:
+    const Board& board;
+    const Move* killers;
+    const int (*history)[64];
+    Move tt_move;             // Null unless legal in this position
+    Move killer_moves[2];     // Killers actually emitted (skipped as quiets)
+    int stage;
+    int killer_idx;
+
+    // Captures, then quiets appended; losing captures (SEE < 0) are
+    // moved to the front as they are picked and tried last
+    Move moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int count, cur;
+    int end_bad;
+
+    bool is_emitted(const Move& m) const;
+    bool pick_best(Move& m);
+};
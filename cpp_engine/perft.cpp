@@ -0,0 +1,185 @@
+// ============================================================
+// perft.cpp — Perft, divide, and the reference suite
+// ============================================================
+
+#include "perft.h"
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+// ─── Reference positions ───────────────────────────────────
+// Standard perft positions with published node counts; together they
+// cover castling (incl. through/out of check), en passant (incl. the
+// horizontal-pin case), promotions and underpromotions, and checks.
+
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+static const PerftCase PERFT_SUITE[] = {
+    { "startpos",   "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",             5,  4865609 },
+    { "kiwipete",   "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,  4085603 },
+    { "endgame-ep", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",                            6, 11030083 },
+    { "promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",     5, 15833292 },
+    { "mirrored",   "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",     5, 15833292 },
+    { "talkchess",  "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",            4,  2103487 },
+    { "middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 },
+    { "ep-pin",     "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1",                                    6,  1134888 },
+    { "ep-check",   "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",                                  6,  1440467 },
+    { "castle-chk", "5k2/8/8/8/8/8/8/4K2R w K - 0 1",                                       6,   661072 },
+    { "castle-atk", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1",                            4,  1274206 },
+    { "castle-blk", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1",                             4,  1720476 },
+    { "promo-evade","2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1",                                    6,  3821001 },
+    { "disc-check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1",                                  5,  1004658 },
+    { "underpromo", "8/P1k5/K7/8/8/8/8/8 w - - 0 1",                                        6,    92683 },
+    { "stalemate",  "K1k5/8/P7/8/8/8/8/8 w - - 0 1",                                        6,     2217 },
+};
+
+// ─── Subtree cache ─────────────────────────────────────────
+// One slot per index, always replaced; depth is part of the match
+// because the same position is reached at different remaining depths.
+
+struct PerftEntry {
+    uint64_t key;
+    uint64_t nodes;
+    int      depth;
+};
+
+class PerftHash {
+public:
+    explicit PerftHash(int mb) {
+        size_t entries = ((size_t)mb * 1024 * 1024) / sizeof(PerftEntry);
+        size_t size = 1;
+        while (size * 2 <= entries) size *= 2;
+        table.assign(size, PerftEntry{0, 0, 0});
+        mask = size - 1;
+    }
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const {
+        const PerftEntry& e = table[key & mask];
+        if (e.key != key || e.depth != depth) return false;
+        nodes = e.nodes;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        table[key & mask] = PerftEntry{key, nodes, depth};
+    }
+
+private:
+    std::vector<PerftEntry> table;
+    size_t mask;
+};
+
+// ─── Perft ─────────────────────────────────────────────────
+
+static uint64_t perft_rec(Board& board, int depth, bool bulk, PerftHash* tt) {
+    if (depth <= 0) return 1;
+
+    uint64_t nodes = 0;
+    if (tt && tt->probe(board.hash, depth, nodes)) return nodes;
+
+    Move moves[MAX_MOVES];
+    int n = board.gen_legal_moves(moves);
+    if (bulk && depth == 1) return n;
+
+    for (int i = 0; i < n; i++) {
+        UndoInfo undo;
+        board.make_move(moves[i], undo);
+        nodes += perft_rec(board, depth - 1, bulk, tt);
+        board.unmake_move(moves[i], undo);
+    }
+
+    if (tt) tt->store(board.hash, depth, nodes);
+    return nodes;
+}
+
+uint64_t perft(Board& board, int depth, const PerftOptions& opt) {
+    std::unique_ptr<PerftHash> tt;
+    if (opt.hash_mb > 0) tt.reset(new PerftHash(opt.hash_mb));
+    return perft_rec(board, depth, opt.bulk, tt.get());
+}
+
+static double elapsed_sec(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void print_rate(std::ostream& out, uint64_t nodes, double sec) {
+    out << "nodes " << nodes
+        << " time " << (int)(sec * 1000)
+        << " nps " << (uint64_t)(sec > 0 ? nodes / sec : 0) << std::endl;
+}
+
+uint64_t perft_report(Board& board, int depth, const PerftOptions& opt, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = perft(board, depth, opt);
+    out << "perft depth " << depth << " ";
+    print_rate(out, nodes, elapsed_sec(start));
+    return nodes;
+}
+
+uint64_t perft_divide(Board& board, int depth, const PerftOptions& opt, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<PerftHash> tt;
+    if (opt.hash_mb > 0) tt.reset(new PerftHash(opt.hash_mb));
+
+    Move moves[MAX_MOVES];
+    int n = board.gen_legal_moves(moves);
+    uint64_t total = 0;
+    for (int i = 0; i < n; i++) {
+        UndoInfo undo;
+        board.make_move(moves[i], undo);
+        uint64_t nodes = perft_rec(board, depth - 1, opt.bulk, tt.get());
+        board.unmake_move(moves[i], undo);
+        out << moves[i].uci() << ": " << nodes << "\n";
+        total += nodes;
+    }
+
+    print_rate(out, total, elapsed_sec(start));
+    return total;
+}
+
+bool perft_suite(const PerftOptions& opt, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+    int failed = 0;
+
+    for (const PerftCase& pc : PERFT_SUITE) {
+        Board board;
+        board.set_fen(pc.fen);
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(board, pc.depth, opt);
+        double sec = elapsed_sec(t0);
+        total += nodes;
+
+        bool ok = nodes == pc.nodes;
+        if (!ok) failed++;
+        out << (ok ? "ok   " : "FAIL ") << pc.name
+            << " depth " << pc.depth
+            << " nodes " << nodes;
+        if (!ok) out << " expected " << pc.nodes;
+        out << " nps " << (uint64_t)(sec > 0 ? nodes / sec : 0) << "\n";
+    }
+
+    if (failed) out << "FAILED " << failed << " of " << std::size(PERFT_SUITE) << " ";
+    else        out << "passed ";
+    print_rate(out, total, elapsed_sec(start));
+    return failed == 0;
+}
+
+void parse_perft_args(std::istream& in, PerftOptions& opt, int& depth, std::string& fen) {
+    std::string tok;
+    while (in >> tok) {
+        if (tok == "bulk") { opt.bulk = true; continue; }
+        if (tok == "hash") { in >> opt.hash_mb; continue; }
+        depth = std::atoi(tok.c_str());
+        break;
+    }
+    std::getline(in, fen);
+    while (!fen.empty() && fen.front() == ' ') fen.erase(fen.begin());
+}
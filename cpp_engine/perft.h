@@ -0,0 +1,32 @@
+#pragma once
+// ============================================================
+// perft.h — Move generation validation and benchmarking
+// ============================================================
+
+#include "board.h"
+#include <istream>
+#include <ostream>
+#include <string>
+
+struct PerftOptions {
+    bool bulk = false;    // Count moves at depth 1 instead of making them
+    int  hash_mb = 0;     // >0: cache subtree counts keyed by Board::hash
+};
+
+// Counts leaf nodes of the legal move tree to the given depth
+uint64_t perft(Board& board, int depth, const PerftOptions& opt = PerftOptions());
+
+// Perft with a one-line summary: nodes, time and nodes per second
+uint64_t perft_report(Board& board, int depth, const PerftOptions& opt, std::ostream& out);
+
+// Perft with per-root-move subtotals ("divide"), followed by the total,
+// time and nodes per second
+uint64_t perft_divide(Board& board, int depth, const PerftOptions& opt, std::ostream& out);
+
+// Runs the built-in suite of reference positions; returns true if every
+// node count matches
+bool perft_suite(const PerftOptions& opt, std::ostream& out);
+
+// Parses "[bulk] [hash <mb>] [<depth> [FEN]]"; depth is left unchanged
+// and fen empty when absent
+void parse_perft_args(std::istream& in, PerftOptions& opt, int& depth, std::string& fen);
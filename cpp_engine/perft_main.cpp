@@ -0,0 +1,54 @@
+// ============================================================
+// perft_main.cpp — Standalone perft tool (make perft)
+//
+// Usage:
+//   perft.exe [opts]                       — run the reference suite
+//   perft.exe [opts] <depth> [FEN]         — count nodes (default: start position)
+//   perft.exe divide [opts] <depth> [FEN]  — per-move subtotals
+//
+// Options:
+//   bulk        count leaf moves at depth 1 without making them
+//   hash <mb>   cache subtree counts keyed by the Zobrist hash
+//
+// Exit status is non-zero if any suite position mismatches.
+// ============================================================
+
+#include "perft.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+int main(int argc, char** argv) {
+    Board::init_zobrist();
+    init_bitboards();
+    init_psqt();
+
+    std::string args;
+    for (int i = 1; i < argc; i++) args += std::string(argv[i]) + ' ';
+    std::istringstream ss(args);
+
+    bool divide = args.compare(0, 7, "divide ") == 0;
+    if (divide) { std::string cmd; ss >> cmd; }
+
+    PerftOptions opt;
+    int depth = 0;
+    std::string fen;
+    parse_perft_args(ss, opt, depth, fen);
+    while (!fen.empty() && fen.back() == ' ') fen.pop_back();
+
+    if (depth <= 0) {
+        if (divide) {
+            std::cerr << "usage: perft.exe [divide] [bulk] [hash <mb>] <depth> [FEN]" << std::endl;
+            return 2;
+        }
+        return perft_suite(opt, std::cout) ? 0 : 1;
+    }
+
+    Board board;
+    board.set_fen(fen.empty() ? START_FEN : fen);
+    if (divide) perft_divide(board, depth, opt, std::cout);
+    else        perft_report(board, depth, opt, std::cout);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+// ============================================================
+// psqt.h — Material + piece-square values per piece and square
+// ============================================================
+
+#include "types.h"
+
+// [piece_index][square], White-positive (black entries are negated) and
+// including material, so a position's sum is its material + PST score.
+extern int PSQ_MG[13][64];
+extern int PSQ_EG[13][64];
+
+// ─── Game phase ─────────────────────────────────────────────
+// Non-pawn material weights; PHASE_MAX is the starting position and
+// 0 means pawns and kings only. Scores taper from MG to EG as it drops.
+constexpr int PHASE_INC[7] = { 0, 0, 1, 1, 2, 4, 0 };
+constexpr int PHASE_MAX = 24;
+
+inline int taper(int mg, int eg, int phase) {
+    if (phase > PHASE_MAX) phase = PHASE_MAX; // Extra promoted pieces
+    return (mg * phase + eg * (PHASE_MAX - phase)) / PHASE_MAX;
+}
+
+void init_psqt();
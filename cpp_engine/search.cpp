@@ -3,154 +3,34 @@
 // ============================================================
 
 #include "search.h"
+#include "movepick.h"
 #include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <thread>
 
 // ============================================================
-// Piece-Square Tables (from White's perspective, a8=index 0)
+// Pawn structure (cached in the pawn hash table)
 // ============================================================
 
-static const int PST_PAWN[64] = {
-     0,  0,  0,  0,  0,  0,  0,  0,
-    50, 50, 50, 50, 50, 50, 50, 50,
-    10, 10, 20, 30, 30, 20, 10, 10,
-     5,  5, 10, 25, 25, 10,  5,  5,
-     0,  0,  0, 20, 20,  0,  0,  0,
-     5, -5,-10,  0,  0,-10, -5,  5,
-     5, 10, 10,-20,-20, 10, 10,  5,
-     0,  0,  0,  0,  0,  0,  0,  0
-};
-
-static const int PST_KNIGHT[64] = {
-    -50,-40,-30,-30,-30,-30,-40,-50,
-    -40,-20,  0,  0,  0,  0,-20,-40,
-    -30,  0, 10, 15, 15, 10,  0,-30,
-    -30,  5, 15, 20, 20, 15,  5,-30,
-    -30,  0, 15, 20, 20, 15,  0,-30,
-    -30,  5, 10, 15, 15, 10,  5,-30,
-    -40,-20,  0,  5,  5,  0,-20,-40,
-    -50,-40,-30,-30,-30,-30,-40,-50
-};
-
-static const int PST_BISHOP[64] = {
-    -20,-10,-10,-10,-10,-10,-10,-20,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -10,  0, 10, 10, 10, 10,  0,-10,
-    -10,  5,  5, 10, 10,  5,  5,-10,
-    -10,  0, 10, 10, 10, 10,  0,-10,
-    -10, 10, 10, 10, 10, 10, 10,-10,
-    -10,  5,  0,  0,  0,  0,  5,-10,
-    -20,-10,-10,-10,-10,-10,-10,-20
-};
-
-static const int PST_ROOK[64] = {
-     0,  0,  0,  0,  0,  0,  0,  0,
-     5, 10, 10, 10, 10, 10, 10,  5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-     0,  0,  0,  5,  5,  0,  0,  0
-};
-
-static const int PST_QUEEN[64] = {
-    -20,-10,-10, -5, -5,-10,-10,-20,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -10,  0,  5,  5,  5,  5,  0,-10,
-     -5,  0,  5,  5,  5,  5,  0, -5,
-      0,  0,  5,  5,  5,  5,  0, -5,
-    -10,  5,  5,  5,  5,  5,  0,-10,
-    -10,  0,  5,  0,  0,  0,  0,-10,
-    -20,-10,-10, -5, -5,-10,-10,-20
-};
-
-static const int PST_KING_MG[64] = {
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -20,-30,-30,-40,-40,-30,-30,-20,
-    -10,-20,-20,-20,-20,-20,-20,-10,
-     20, 20,  0,  0,  0,  0, 20, 20,
-     20, 30, 10,  0,  0, 10, 30, 20
-};
-
-static const int PST_KING_EG[64] = {
-    -50,-40,-30,-20,-20,-30,-40,-50,
-    -30,-20,-10,  0,  0,-10,-20,-30,
-    -30,-10, 20, 30, 30, 20,-10,-30,
-    -30,-10, 30, 40, 40, 30,-10,-30,
-    -30,-10, 30, 40, 40, 30,-10,-30,
-    -30,-10, 20, 30, 30, 20,-10,-30,
-    -30,-30,  0,  0,  0,  0,-30,-30,
-    -50,-30,-30,-30,-30,-30,-30,-50
-};
-
-static const int* PST_TABLE[] = {
-    nullptr,     // PT_NONE
-    PST_PAWN,    // PT_PAWN
-    PST_KNIGHT,  // PT_KNIGHT
-    PST_BISHOP,  // PT_BISHOP
-    PST_ROOK,    // PT_ROOK
-    PST_QUEEN,   // PT_QUEEN
-    PST_KING_MG  // PT_KING (middlegame default)
-};
+const PawnEntry& Searcher::probe_pawns(const Board& board) {
+    PawnEntry& e = pawn_table[board.pawn_hash & (PAWN_TABLE_SIZE - 1)];
+    if (e.key == board.pawn_hash) return e;
 
-// ============================================================
-// Evaluation
-// ============================================================
-
-static bool is_endgame(const Board& board) {
-    int queens = 0, minors = 0;
-    for (int sq = 0; sq < 64; sq++) {
-        int pt = piece_type(board.board[sq]);
-        if (pt == PT_QUEEN) queens++;
-        if (pt == PT_KNIGHT || pt == PT_BISHOP) minors++;
-    }
-    return queens == 0 || (queens <= 2 && minors <= 2);
-}
-
-int Searcher::evaluate(const Board& board) const {
+    const Bitboard white_pawns = board.pieces[WHITE_SIDE][PT_PAWN];
+    const Bitboard black_pawns = board.pieces[BLACK_SIDE][PT_PAWN];
     int score = 0;
-    int white_material = 0, black_material = 0;
-    int white_pawns = 0, black_pawns = 0;
-    int white_bishops = 0, black_bishops = 0;
-    bool endgame = is_endgame(board);
 
     // Pawn file tracking for structure eval
-    int white_pawn_files[8] = {0};
-    int black_pawn_files[8] = {0};
-
-    for (int sq = 0; sq < 64; sq++) {
-        int p = board.board[sq];
-        if (p == 0) continue;
-
-        int pt = piece_type(p);
-        int val = PIECE_VAL[pt];
-        const int* pst = (pt == PT_KING && endgame) ? PST_KING_EG : PST_TABLE[pt];
-
-        if (p > 0) { // White
-            white_material += val;
-            int idx = mirror_sq(sq); // PST from white's perspective
-            score += val + (pst ? pst[idx] : 0);
-            if (pt == PT_PAWN) { white_pawns++; white_pawn_files[sq_file(sq)]++; }
-            if (pt == PT_BISHOP) white_bishops++;
-        } else { // Black
-            black_material += val;
-            int idx = sq; // PST already from correct perspective for black
-            score -= val + (pst ? pst[idx] : 0);
-            if (pt == PT_PAWN) { black_pawns++; black_pawn_files[sq_file(sq)]++; }
-            if (pt == PT_BISHOP) black_bishops++;
-        }
+    int white_pawn_files[8], black_pawn_files[8];
+    e.semi_open[WHITE_SIDE] = e.semi_open[BLACK_SIDE] = 0;
+    for (int f = 0; f < 8; f++) {
+        white_pawn_files[f] = popcount(white_pawns & file_bb(f));
+        black_pawn_files[f] = popcount(black_pawns & file_bb(f));
+        if (!white_pawn_files[f]) e.semi_open[WHITE_SIDE] |= 1 << f;
+        if (!black_pawn_files[f]) e.semi_open[BLACK_SIDE] |= 1 << f;
     }
 
-    // Bishop pair bonus
-    if (white_bishops >= 2) score += 30;
-    if (black_bishops >= 2) score -= 30;
-
-    // Pawn structure
     for (int f = 0; f < 8; f++) {
         // Doubled pawns penalty
         if (white_pawn_files[f] > 1) score -= 10 * (white_pawn_files[f] - 1);
@@ -163,129 +43,388 @@ int Searcher::evaluate(const Board& board) const {
         if (black_pawn_files[f] && !b_adj) score += 15;
     }
 
-    // Passed pawn bonus
-    for (int sq = 0; sq < 64; sq++) {
-        int p = board.board[sq];
-        if (p == W_PAWN) {
-            int f = sq_file(sq), r = sq_rank(sq);
-            bool passed = true;
-            for (int rr = r + 1; rr < 8 && passed; rr++) {
-                for (int ff = std::max(0, f-1); ff <= std::min(7, f+1); ff++) {
-                    if (board.board[make_sq(ff, rr)] == B_PAWN) { passed = false; break; }
-                }
-            }
-            if (passed) score += 20 + 10 * r; // More bonus the further advanced
-        }
-        if (p == B_PAWN) {
-            int f = sq_file(sq), r = sq_rank(sq);
-            bool passed = true;
-            for (int rr = r - 1; rr >= 0 && passed; rr--) {
-                for (int ff = std::max(0, f-1); ff <= std::min(7, f+1); ff++) {
-                    if (board.board[make_sq(ff, rr)] == W_PAWN) { passed = false; break; }
-                }
-            }
-            if (passed) score -= 20 + 10 * (7 - r);
-        }
+    // Passed pawn bonus (more bonus the further advanced)
+    e.passed = 0;
+    for (Bitboard b = white_pawns; b; ) {
+        int sq = pop_lsb(b);
+        if (PASSED_PAWN_MASK[WHITE_SIDE][sq] & black_pawns) continue;
+        e.passed |= sq_bb(sq);
+        score += 20 + 10 * sq_rank(sq);
     }
+    for (Bitboard b = black_pawns; b; ) {
+        int sq = pop_lsb(b);
+        if (PASSED_PAWN_MASK[BLACK_SIDE][sq] & white_pawns) continue;
+        e.passed |= sq_bb(sq);
+        score -= 20 + 10 * (7 - sq_rank(sq));
+    }
+
+    e.key = board.pawn_hash;
+    e.score = score;
+    return e;
+}
+
+// ============================================================
+// Evaluation
+// ============================================================
+
+// Side to move has a piece other than pawns and king (null-move guard)
+static bool has_non_pawn_material(const Board& board) {
+    const Bitboard* bb = board.pieces[board.side];
+    return (bb[PT_KNIGHT] | bb[PT_BISHOP] | bb[PT_ROOK] | bb[PT_QUEEN]) != 0;
+}
+
+int Searcher::evaluate(const Board& board) {
+    // Phase-independent terms accumulate here; material + PST (kept up to
+    // date by make_move) and king safety are tapered by game phase below
+    int score = 0;
+    int mg = board.psq_mg, eg = board.psq_eg;
+
+    // Bishop pair bonus
+    if (more_than_one(board.pieces[WHITE_SIDE][PT_BISHOP])) score += 30;
+    if (more_than_one(board.pieces[BLACK_SIDE][PT_BISHOP])) score -= 30;
+
+    // Doubled, isolated and passed pawns
+    const PawnEntry& pawns = probe_pawns(board);
+    score += pawns.score;
+    int white_open = pawns.semi_open[WHITE_SIDE], black_open = pawns.semi_open[BLACK_SIDE];
 
     // Rook on open/semi-open file
-    for (int sq = 0; sq < 64; sq++) {
-        int p = board.board[sq];
-        if (piece_type(p) != PT_ROOK) continue;
-        int f = sq_file(sq);
-        if (p > 0) {
-            if (!white_pawn_files[f] && !black_pawn_files[f]) score += 20; // Open
-            else if (!white_pawn_files[f]) score += 10; // Semi-open
-        } else {
-            if (!white_pawn_files[f] && !black_pawn_files[f]) score -= 20;
-            else if (!black_pawn_files[f]) score -= 10;
-        }
+    for (Bitboard b = board.pieces[WHITE_SIDE][PT_ROOK]; b; ) {
+        int f = 1 << sq_file(pop_lsb(b));
+        if (white_open & black_open & f) score += 20; // Open
+        else if (white_open & f) score += 10; // Semi-open
+    }
+    for (Bitboard b = board.pieces[BLACK_SIDE][PT_ROOK]; b; ) {
+        int f = 1 << sq_file(pop_lsb(b));
+        if (white_open & black_open & f) score -= 20;
+        else if (black_open & f) score -= 10;
     }
 
-    // King safety: pawn shield in middlegame
-    if (!endgame) {
-        for (int s = 0; s < 2; s++) {
-            int ksq = board.king_sq[s];
-            int kf = sq_file(ksq), kr = sq_rank(ksq);
-            int shield = 0;
-            int pawn = (s == WHITE_SIDE) ? W_PAWN : B_PAWN;
-            int dir = (s == WHITE_SIDE) ? 1 : -1;
-
-            for (int df = -1; df <= 1; df++) {
-                int ff = kf + df;
-                if (ff < 0 || ff > 7) continue;
-                int sr = kr + dir;
-                if (sr >= 0 && sr < 8 && board.board[make_sq(ff, sr)] == pawn) shield++;
-                sr = kr + 2 * dir;
-                if (sr >= 0 && sr < 8 && board.board[make_sq(ff, sr)] == pawn) shield++;
-            }
-            if (s == WHITE_SIDE) score += shield * 10;
-            else score -= shield * 10;
+    // Passed pawns, endgame only: worth more the further the defending
+    // king is from the stop square, the nearer ours, and if it is empty
+    for (Bitboard b = pawns.passed; b; ) {
+        int sq = pop_lsb(b);
+        int s = piece_side(board.board[sq]);
+        int w = (s == WHITE_SIDE ? sq_rank(sq) : 7 - sq_rank(sq)) - 2;
+        if (w <= 0) continue;
+        int stop = sq + (s == WHITE_SIDE ? 8 : -8);
+        int bonus = w * (5 * sq_distance(stop, board.king_sq[s ^ 1]) -
+                         2 * sq_distance(stop, board.king_sq[s]));
+        if (!board.board[stop]) bonus += 5 * w;
+        eg += s == WHITE_SIDE ? bonus : -bonus;
+    }
+
+    // King safety: pawn shield, middlegame only
+    for (int s = 0; s < 2; s++) {
+        int ksq = board.king_sq[s];
+        int kf = sq_file(ksq), kr = sq_rank(ksq);
+        int shield = 0;
+        int pawn = (s == WHITE_SIDE) ? W_PAWN : B_PAWN;
+        int dir = (s == WHITE_SIDE) ? 1 : -1;
+
+        for (int df = -1; df <= 1; df++) {
+            int ff = kf + df;
+            if (ff < 0 || ff > 7) continue;
+            int sr = kr + dir;
+            if (sr >= 0 && sr < 8 && board.board[make_sq(ff, sr)] == pawn) shield++;
+            sr = kr + 2 * dir;
+            if (sr >= 0 && sr < 8 && board.board[make_sq(ff, sr)] == pawn) shield++;
         }
+        if (s == WHITE_SIDE) mg += shield * 10;
+        else mg -= shield * 10;
     }
 
     // Return from White's perspective
-    return score;
+    return score + taper(mg, eg, board.phase);
 }
 
 // ============================================================
 // Transposition Table
 // ============================================================
 
-Searcher::Searcher(int tt_size_mb) : tt_hits(0), tt_stores(0), nodes(0),
-                                     max_time(0), time_up(false) {
-    int entries = (tt_size_mb * 1024 * 1024) / sizeof(TTEntry);
+// Data word layout:
+//   bits  0-15  move (from 6 | to 6 | promotion+8 4)
+//   bits 16-47  score (signed 32)
+//   bits 48-55  depth (signed 8)
+//   bits 56-57  flag
+//   bits 58-63  generation
+static uint64_t tt_pack(const Move& m, int score, int depth, TTFlag flag, int gen) {
+    uint64_t move = m.from | (m.to << 6) | ((m.promotion + 8) << 12);
+    return move
+         | ((uint64_t)(uint32_t)score << 16)
+         | ((uint64_t)(uint8_t)depth << 48)
+         | ((uint64_t)flag << 56)
+         | ((uint64_t)gen << 58);
+}
+
+static Move  tt_move(uint64_t d)  { return Move(d & 63, (d >> 6) & 63, 0, (int)((d >> 12) & 15) - 8); }
+static int   tt_score(uint64_t d) { return (int32_t)(uint32_t)(d >> 16); }
+static int   tt_depth(uint64_t d) { return (int8_t)(uint8_t)(d >> 48); }
+static TTFlag tt_flag(uint64_t d) { return (TTFlag)((d >> 56) & 3); }
+static int   tt_gen(uint64_t d)   { return (int)(d >> 58); }
+
+// Mate in N from the root is stored as mate in N - ply from this node
+static int score_to_tt(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY)  return score + ply;
+    if (score <= -MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+static int score_from_tt(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY)  return score - ply;
+    if (score <= -MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+TranspositionTable::TranspositionTable(int size_mb) : generation(0) {
+    size_t clusters = ((size_t)size_mb * 1024 * 1024) / sizeof(TTCluster);
     // Round down to power of 2
-    int size = 1;
-    while (size * 2 <= entries) size *= 2;
-    tt.resize(size);
-    tt_mask = size - 1;
+    size_t size = 1;
+    while (size * 2 <= clusters) size *= 2;
+    table.reset(new TTCluster[size]());
+    mask = size - 1;
+}
+
+bool TranspositionTable::store(uint64_t key, int depth, int ply, int score,
+                               TTFlag flag, const Move& best) {
+    TTCluster& c = table[key & mask];
+    score = score_to_tt(score, ply);
+
+    // Same position if present, else the shallowest / oldest entry
+    TTEntry* slot = nullptr;
+    int worst = 1 << 30;
+    for (TTEntry& e : c.entries) {
+        uint64_t d = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor.load(std::memory_order_relaxed) ^ d) == key) {
+            // Keep deeper results of this search unless we now have an exact score
+            if (depth < tt_depth(d) && flag != TT_EXACT && tt_gen(d) == generation)
+                return false;
+            Move m = best.is_null() ? tt_move(d) : best;
+            uint64_t nd = tt_pack(m, score, depth, flag, generation);
+            e.data.store(nd, std::memory_order_relaxed);
+            e.key_xor.store(key ^ nd, std::memory_order_relaxed);
+            return true;
+        }
+        int age = (generation - tt_gen(d)) & 63;
+        int value = (d ? tt_depth(d) : -1000) - 8 * age;
+        if (value < worst) { worst = value; slot = &e; }
+    }
+
+    uint64_t nd = tt_pack(best, score, depth, flag, generation);
+    slot->data.store(nd, std::memory_order_relaxed);
+    slot->key_xor.store(key ^ nd, std::memory_order_relaxed);
+    return true;
+}
+
+bool TranspositionTable::lookup(uint64_t key, int ply, int& score, int& depth,
+                                TTFlag& flag, Move& best) const {
+    const TTCluster& c = table[key & mask];
+    for (const TTEntry& e : c.entries) {
+        uint64_t d = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor.load(std::memory_order_relaxed) ^ d) != key) continue;
+        best = tt_move(d);
+        score = score_from_tt(tt_score(d), ply);
+        depth = tt_depth(d);
+        flag = tt_flag(d);
+        return true;
+    }
+    return false;
+}
+
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    for (int i = 0; i < 1000 / TT_CLUSTER_SIZE; i++)
+        for (const TTEntry& e : table[i].entries) {
+            uint64_t d = e.data.load(std::memory_order_relaxed);
+            if (d && tt_gen(d) == generation) used++;
+        }
+    return used * 1000 / (1000 / TT_CLUSTER_SIZE * TT_CLUSTER_SIZE);
+}
+
+bool TranspositionTable::probe(uint64_t key, int depth, int ply, int alpha,
+                               int beta, int& score, Move& best) const {
+    int entry_score, entry_depth;
+    TTFlag flag;
+    if (!lookup(key, ply, entry_score, entry_depth, flag, best)) return false;
+    if (entry_depth < depth) return false;
+
+    score = entry_score;
+    if (flag == TT_EXACT) { return true; }
+    if (flag == TT_LOWER && score >= beta)  { return true; }
+    if (flag == TT_UPPER && score <= alpha) { return true; }
+    return false;
+}
+
+// ============================================================
+// Searcher construction and threads
+// ============================================================
+
+// ─── Late move reductions ───────────────────────────────────
+// Base reduction grows with log(depth) * log(move number); built once
+
+static int LMR_TABLE[64][64];
+static bool lmr_init_done = false;
+
+static void init_lmr() {
+    if (lmr_init_done) return;
+    for (int d = 1; d < 64; d++)
+        for (int i = 1; i < 64; i++)
+            LMR_TABLE[d][i] = (int)(0.75 + std::log(d) * std::log(i) / 2.25);
+    lmr_init_done = true;
+}
+
+constexpr int EVAL_NONE = INF_SCORE;   // Static eval unknown (in check)
+
+Searcher::Searcher(int tt_size_mb, int threads)
+    : tt(std::make_shared<TranspositionTable>(tt_size_mb)),
+      tt_hits(0), tt_stores(0), tt_probes(0), thread_id(0), nodes(0), seldepth(0),
+      root_depth(0), prev_pv_length(0), follow_pv(false), next_root_hash(0),
+      start_ms(0), max_time(0), node_limit(0), external_stop(nullptr),
+      stop_flag(false), stop(&stop_flag),
+      pawn_table(PAWN_TABLE_SIZE, PawnEntry{~0ULL, 0, 0, {0, 0}}) {
+    init_lmr();
+    memset(history, 0, sizeof(history));
+    memset(killers, 0, sizeof(killers));
+    memset(path_ext, 0, sizeof(path_ext));
+    std::fill(static_evals, static_evals + MAX_PLY, EVAL_NONE);
+    set_threads(threads);
+}
+
+Searcher::Searcher(std::shared_ptr<TranspositionTable> shared_tt,
+                   std::atomic<bool>* shared_stop, int id)
+    : tt(std::move(shared_tt)), tt_hits(0), tt_stores(0), tt_probes(0), thread_id(id),
+      nodes(0), seldepth(0), root_depth(0), prev_pv_length(0), follow_pv(false),
+      next_root_hash(0), start_ms(0), max_time(0), node_limit(0), external_stop(nullptr),
+      stop_flag(false), stop(shared_stop),
+      pawn_table(PAWN_TABLE_SIZE, PawnEntry{~0ULL, 0, 0, {0, 0}}) {
     memset(history, 0, sizeof(history));
     memset(killers, 0, sizeof(killers));
-    for (auto& e : tt) e.key = 0;
+    memset(path_ext, 0, sizeof(path_ext));
+    std::fill(static_evals, static_evals + MAX_PLY, EVAL_NONE);
 }
 
-void Searcher::tt_store(uint64_t key, int depth, int score, TTFlag flag, const Move& best) {
-    int idx = (int)(key & tt_mask);
-    TTEntry& e = tt[idx];
-    // Replace if: new depth >= stored depth, or different position
-    if (e.key != key || depth >= e.depth) {
-        e.key = key;
-        e.score = (int16_t)score;
-        e.depth = (int8_t)depth;
-        e.flag = flag;
-        e.best = best;
-        tt_stores++;
+void Searcher::new_game() {
+    memset(history, 0, sizeof(history));
+    memset(killers, 0, sizeof(killers));
+    for (auto& h : helpers) h->new_game();
+    tt->new_search();
+}
+
+// When the new root is the position two plies past the last PV (the
+// expected reply was played), killers move up two plies; any other root
+// starts with fresh killers. History keeps half its weight either way.
+void Searcher::age_tables(const Board& root) {
+    if (root.hash == next_root_hash) {
+        std::copy(&killers[0][0] + 2 * 2, &killers[0][0] + MAX_PLY * 2, &killers[0][0]);
+        for (int ply = MAX_PLY - 2; ply < MAX_PLY; ply++)
+            killers[ply][0] = killers[ply][1] = Move();
+    } else {
+        memset(killers, 0, sizeof(killers));
     }
+    for (auto& side : history)
+        for (auto& row : side)
+            for (auto& v : row) v >>= 1;
+}
+
+void Searcher::set_hash(int size_mb) {
+    tt = std::make_shared<TranspositionTable>(size_mb);
+    set_threads((int)helpers.size() + 1);
 }
 
-bool Searcher::tt_probe(uint64_t key, int depth, int alpha, int beta,
-                        int& score, Move& best) const {
-    int idx = (int)(key & tt_mask);
-    const TTEntry& e = tt[idx];
-    if (e.key != key) return false;
-    best = e.best;
+void Searcher::set_threads(int threads) {
+    helpers.clear();
+    for (int i = 1; i < threads; i++)
+        helpers.emplace_back(new Searcher(tt, &stop_flag, i));
+}
 
-    if (e.depth >= depth) {
-        score = e.score;
+void Searcher::tt_store(uint64_t key, int depth, int ply, int score, TTFlag flag,
+                        const Move& best) {
+    if (tt->store(key, depth, ply, score, flag, best)) tt_stores++;
+}
 
-        if (e.flag == TT_EXACT) { return true; }
-        if (e.flag == TT_LOWER && score >= beta)  { return true; }
-        if (e.flag == TT_UPPER && score <= alpha) { return true; }
-    }
-    return false;
+bool Searcher::tt_probe(uint64_t key, int depth, int ply, int alpha, int beta,
+                        int& score, Move& best) {
+    tt_probes++;
+    return tt->probe(key, depth, ply, alpha, beta, score, best);
 }
 
 // ============================================================
 // Time Management
 // ============================================================
 
+static int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Searcher::elapsed_ms() const {
+    return (int)(now_ms() - start_ms.load(std::memory_order_relaxed));
+}
+
 void Searcher::check_time() {
-    if (max_time <= 0) return;
-    auto now = std::chrono::steady_clock::now();
-    int elapsed = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - start_time).count();
-    if (elapsed >= max_time) time_up = true;
+    if ((external_stop && external_stop->load(std::memory_order_relaxed)) ||
+        (node_limit && nodes >= node_limit)) {
+        stop->store(true, std::memory_order_relaxed);
+        return;
+    }
+    int limit = max_time.load(std::memory_order_relaxed);
+    if (limit <= 0) return;
+    if (elapsed_ms() >= limit) stop->store(true, std::memory_order_relaxed);
+}
+
+void Searcher::ponderhit(int movetime_ms) {
+    max_time.store(elapsed_ms() + std::max(1, movetime_ms));
+}
+
+// ============================================================
+// Progress reporting
+// ============================================================
+
+void Searcher::report(int depth, int score, const Move& best) {
+    if (!info_callback) return;
+
+    SearchInfo info;
+    info.depth = depth;
+    info.seldepth = seldepth;
+    info.score = score;
+    info.nodes = nodes;
+    int probes = tt_probes, hits = tt_hits;
+    for (auto& h : helpers)
+        info.nodes += h->nodes.load(std::memory_order_relaxed);
+    info.time_ms = elapsed_ms();
+    info.nps = info.nodes * 1000 / std::max(1, info.time_ms);
+    info.hashfull = tt->hashfull();
+    info.tt_hit_rate = probes ? (int)((int64_t)hits * 1000 / probes) : 0;
+    info.pv.assign(pv[0], pv[0] + pv_length[0]);
+    if (info.pv.empty()) info.pv.push_back(best);
+    info_callback(info);
+}
+
+// ============================================================
+// Principal Variation
+// ============================================================
+
+void Searcher::update_pv(int ply, const Move& m) {
+    pv[ply][0] = m;
+    int n = ply + 1 < MAX_PLY ? std::min(pv_length[ply + 1], MAX_PLY - ply - 1) : 0;
+    for (int i = 0; i < n; i++) pv[ply][i + 1] = pv[ply + 1][i];
+    pv_length[ply] = n + 1;
+}
+
+// Keeps the tail of the final PV for the next search, which starts two
+// plies on if the opponent plays the expected reply
+void Searcher::save_pv(const Board& root) {
+    prev_pv_length = 0;
+    next_root_hash = 0;
+    if (pv_length[0] < 3) return;
+
+    Board b = root;
+    UndoInfo undo;
+    b.make_move(pv[0][0], undo);
+    b.make_move(pv[0][1], undo);
+    next_root_hash = b.hash;
+    prev_pv_length = pv_length[0] - 2;
+    std::copy(pv[0] + 2, pv[0] + pv_length[0], prev_pv);
 }
 
 // ============================================================
@@ -300,10 +439,12 @@ void Searcher::score_moves(const Board& board, Move* moves, int count,
         if (m == tt_move) {
             scores[i] = 10000000;
         } else if (m.captured) {
-            // MVV-LVA: victim value * 10 - attacker value
+            // MVV-LVA: victim value * 10 - attacker value; losing
+            // captures (by SEE) go after all quiet moves
             int victim = PIECE_VAL[piece_type(m.captured)];
             int attacker = PIECE_VAL[piece_type(board.board[m.from])];
-            scores[i] = 5000000 + victim * 10 - attacker;
+            int base = board.see(m) >= 0 ? 5000000 : -5000000;
+            scores[i] = base + victim * 10 - attacker;
         } else if (m.promotion) {
             scores[i] = 4500000 + PIECE_VAL[piece_type(m.promotion)];
         } else if (ply < MAX_PLY && m == killers[ply][0]) {
@@ -330,23 +471,73 @@ void Searcher::sort_moves(Move* moves, int* scores, int count, int start) const
 }
 
 // ============================================================
-// Search: Iterative Deepening
+// Search: Lazy SMP driver
 // ============================================================
 
 SearchResult Searcher::search(Board& board, int max_depth, int max_time_ms) {
-    start_time = std::chrono::steady_clock::now();
-    max_time = max_time_ms;
-    time_up = false;
+    SearchLimits limits;
+    limits.depth = max_depth;
+    limits.movetime = max_time_ms;
+    return search(board, limits);
+}
+
+SearchResult Searcher::search(Board& board, const SearchLimits& limits) {
+    int max_depth = limits.depth;
+    start_ms = now_ms();
+    max_time = limits.movetime;
+    node_limit = limits.nodes;
+    external_stop = limits.stop;
+    stop_flag.store(false);
+    tt->new_search();
+
+    // Helpers search the same root on their own board copies; they share
+    // only the TT, which is what makes their work useful to the main thread
+    std::vector<Board> boards(helpers.size(), board);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < helpers.size(); i++) {
+        Searcher* h = helpers[i].get();
+        h->start_ms.store(start_ms.load());
+        h->max_time = 0; // Helpers stop when the main thread does
+        threads.emplace_back([h, &boards, i, max_depth] { h->iterate(boards[i], max_depth); });
+    }
+    if (limits.started) limits.started();
+
+    SearchResult result = iterate(board, max_depth);
+
+    stop_flag.store(true);
+    for (auto& t : threads) t.join();
+    for (auto& h : helpers) {
+        result.nodes += h->nodes;
+        result.tt_hits += h->tt_hits;
+        result.tt_stores += h->tt_stores;
+    }
+
+    result.time_ms = elapsed_ms();
+    return result;
+}
+
+// ============================================================
+// Search: Iterative Deepening
+// ============================================================
+
+SearchResult Searcher::iterate(Board& board, int max_depth) {
     nodes = 0;
+    seldepth = 0;
     tt_hits = 0;
     tt_stores = 0;
-    memset(killers, 0, sizeof(killers));
-    memset(history, 0, sizeof(history));
+    tt_probes = 0;
+    age_tables(board);
+    pv_length[0] = 0;
+    if (board.hash != next_root_hash) prev_pv_length = 0;
 
     SearchResult result;
     result.best_move = Move();
     result.score = 0;
     result.depth = 0;
+    result.nodes = 0;
+    result.time_ms = 0;
+    result.tt_hits = 0;
+    result.tt_stores = 0;
 
     // Get initial legal moves
     Move legal[MAX_MOVES];
@@ -356,48 +547,66 @@ SearchResult Searcher::search(Board& board, int max_depth, int max_time_ms) {
 
     if (max_depth <= 0) max_depth = 100; // unlimited — time controls us
 
-    for (int depth = 1; depth <= max_depth; depth++) {
+    // Odd helpers start one ply deeper so threads spread across depths
+    for (int depth = 1 + (thread_id & 1); depth <= max_depth; depth++) {
         Move best;
         int score;
 
-        // Aspiration windows (from depth 5+)
+        // Aspiration window around the previous score (from depth 5+),
+        // widened progressively on the failing side
+        int delta = 25;
+        int alpha = -INF_SCORE, beta = INF_SCORE;
         if (depth >= 5) {
-            int delta = 50;
-            int alpha = result.score - delta;
-            int beta  = result.score + delta;
-
-            score = root_search(board, depth, best);
+            alpha = std::max(result.score - delta, -INF_SCORE);
+            beta  = std::min(result.score + delta,  INF_SCORE);
+        }
 
-            // If fell outside window, re-search with full window
-            if (time_up) break;
-            if (score <= alpha || score >= beta) {
-                score = root_search(board, depth, best);
+        while (true) {
+            score = root_search(board, depth, alpha, beta, best);
+            if (stopped()) break;
+
+            if (score <= alpha) {
+                // Fail low: no move is known good, pull beta in and drop alpha
+                beta  = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -INF_SCORE);
+            } else if (score >= beta) {
+                // Fail high: best already refutes the old window
+                beta  = std::min(score + delta, INF_SCORE);
+            } else {
+                break;
             }
-        } else {
-            score = root_search(board, depth, best);
+            delta += delta / 2;
+            if (delta > 1000) alpha = -INF_SCORE, beta = INF_SCORE;
         }
 
-        if (time_up && depth > 1) break; // Use previous iteration's result
+        if (stopped() && depth > 1) break; // Use previous iteration's result
 
         if (!best.is_null()) {
             result.best_move = best;
             result.score = score;
             result.depth = depth;
+            result.pv.assign(pv[0], pv[0] + pv_length[0]);
+            if (thread_id == 0) report(depth, score, best);
+
+            // Seed the next iteration's ordering
+            prev_pv_length = pv_length[0];
+            std::copy(pv[0], pv[0] + pv_length[0], prev_pv);
         }
 
-        // If found mate, no point searching deeper
-        if (abs(score) > MATE_SCORE - 100) break;
+        // Stop once a mate lies inside the full-width horizon
+        if (abs(score) >= MATE_IN_MAX_PLY && depth >= MATE_SCORE - abs(score)) break;
 
         // Time check: don't start next depth if >50% used
-        auto now = std::chrono::steady_clock::now();
-        int elapsed = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - start_time).count();
-        if (max_time_ms > 0 && elapsed > max_time_ms / 2) break;
+        int limit = max_time.load(std::memory_order_relaxed);
+        if (limit > 0 && elapsed_ms() > limit / 2) break;
     }
 
-    auto end = std::chrono::steady_clock::now();
-    result.time_ms = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
-        end - start_time).count();
+    if (result.pv.empty() && !result.best_move.is_null())
+        result.pv.push_back(result.best_move);
+    pv_length[0] = (int)result.pv.size();
+    std::copy(result.pv.begin(), result.pv.end(), pv[0]);
+    save_pv(board);
+
     result.nodes = nodes;
     result.tt_hits = tt_hits;
     result.tt_stores = tt_stores;
@@ -408,7 +617,9 @@ SearchResult Searcher::search(Board& board, int max_depth, int max_time_ms) {
 // Root Search
 // ============================================================
 
-int Searcher::root_search(Board& board, int depth, Move& best_move) {
+// Fail-soft search of the root within (alpha, beta); the result is
+// exact only when it lands strictly inside the window.
+int Searcher::root_search(Board& board, int depth, int alpha, int beta, Move& best_move) {
     Move moves[MAX_MOVES];
     int n = board.gen_legal_moves(moves);
     if (n == 0) {
@@ -419,33 +630,60 @@ int Searcher::root_search(Board& board, int depth, Move& best_move) {
     int scores[MAX_MOVES];
     Move tt_best;
     int tt_score;
-    if (tt_probe(board.hash, 0, -INF_SCORE, INF_SCORE, tt_score, tt_best)) {
+    if (tt_probe(board.hash, 0, 0, -INF_SCORE, INF_SCORE, tt_score, tt_best)) {
         // Just use for ordering, don't trust the score at root
     }
+    if (prev_pv_length > 0) tt_best = prev_pv[0];
     score_moves(board, moves, n, 0, tt_best, scores);
+    pv_length[0] = 0;
 
-    int alpha = -INF_SCORE, beta = INF_SCORE;
+    int alpha_orig = alpha;
     int best_score = -INF_SCORE;
     best_move = moves[0];
+    root_depth = depth;
+    path_ext[1] = 0;
+
+    // Root static eval, the reference for 'improving' at ply 2
+    if (board.in_check()) {
+        static_evals[0] = EVAL_NONE;
+    } else {
+        int eval = evaluate(board);
+        static_evals[0] = board.side == WHITE_SIDE ? eval : -eval;
+    }
 
     for (int i = 0; i < n; i++) {
         sort_moves(moves, scores, n, i);
 
         UndoInfo undo;
         board.make_move(moves[i], undo);
-        int score = -alphabeta(board, depth - 1, -beta, -alpha, 1, true);
+        follow_pv = prev_pv_length > 1 && moves[i] == prev_pv[0];
+        int score;
+        if (i == 0) {
+            score = -alphabeta(board, depth - 1, -beta, -alpha, 1, true);
+        } else {
+            // PVS: prove the move is no better than alpha, re-search if not
+            score = -alphabeta(board, depth - 1, -alpha - 1, -alpha, 1, true);
+            if (score > alpha && score < beta && !stopped())
+                score = -alphabeta(board, depth - 1, -beta, -alpha, 1, true);
+        }
         board.unmake_move(moves[i], undo);
 
-        if (time_up) break;
+        if (stopped()) break;
 
         if (score > best_score) {
             best_score = score;
             best_move = moves[i];
+            update_pv(0, moves[i]);
         }
         if (score > alpha) alpha = score;
+        if (score >= beta) break;
     }
 
-    tt_store(board.hash, depth, best_score, TT_EXACT, best_move);
+    if (!stopped()) {
+        TTFlag flag = best_score >= beta ? TT_LOWER
+                    : best_score <= alpha_orig ? TT_UPPER : TT_EXACT;
+        tt_store(board.hash, depth, 0, best_score, flag, best_move);
+    }
     return best_score;
 }
 
@@ -453,20 +691,60 @@ int Searcher::root_search(Board& board, int depth, Move& best_move) {
 // Alpha-Beta Search
 // ============================================================
 
+
+constexpr int SE_MIN_DEPTH = 8;        // Singular extensions from this depth
+
+// Shallow-depth pruning margins, in centipawns per ply of depth
+constexpr int RFP_MARGIN      = 100;
+constexpr int RAZOR_MARGIN    = 250;
+constexpr int FUTILITY_MARGIN = 150;
+
 int Searcher::alphabeta(Board& board, int depth, int alpha, int beta,
                         int ply, bool null_ok) {
-    nodes++;
+    count_node();
     if ((nodes & 4095) == 0) check_time();
-    if (time_up) return 0;
+    if (ply > seldepth) seldepth = ply;
+    if (ply < MAX_PLY) pv_length[ply] = 0;
+
+    // Only the first node visited at this ply can still be on prev_pv
+    bool on_pv = follow_pv && ply < prev_pv_length;
+    follow_pv = false;
+    if (stopped()) return 0;
+
+    // Ply limit for the per-ply tables
+    if (ply >= MAX_PLY - 1) {
+        int eval = evaluate(board);
+        return board.side == WHITE_SIDE ? eval : -eval;
+    }
+
+    // Draw detection: a repetition inside the tree is a draw already
+    if (board.is_draw(ply)) return 0;
+
+    // Upcoming repetition: if a reversible move repeats an earlier
+    // position, the side to move can hold at least a draw
+    if (alpha < 0 && board.has_game_cycle(ply)) {
+        alpha = 0;
+        if (alpha >= beta) return alpha;
+    }
 
-    // Draw detection
-    if (board.is_draw()) return 0;
+    // Mate distance pruning: no line from here beats mating now or
+    // avoids being mated on the next move
+    alpha = std::max(alpha, -(MATE_SCORE - ply));
+    beta  = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta) return alpha;
 
-    // TT lookup
+    // A singular verification search of this node skips one move, so it
+    // must neither trust nor overwrite the node's TT entry
+    Move excl = ply < MAX_PLY ? excluded[ply] : Move();
+    bool excluding = !excl.is_null();
+
+    // TT lookup. PV nodes search on instead of cutting off, so the
+    // triangular PV is never truncated at a TT hit.
+    bool pv_node = beta - alpha > 1;
     Move tt_best;
     int tt_score;
-    bool tt_hit = tt_probe(board.hash, depth, alpha, beta, tt_score, tt_best);
-    if (tt_hit && ply > 0) {
+    bool tt_hit = tt_probe(board.hash, depth, ply, alpha, beta, tt_score, tt_best);
+    if (tt_hit && !excluding && !pv_node) {
         tt_hits++;
         return tt_score;
     }
@@ -474,66 +752,164 @@ int Searcher::alphabeta(Board& board, int depth, int alpha, int beta,
     // Quiescence at leaf
     if (depth <= 0) return quiescence(board, alpha, beta, ply);
 
+    if (on_pv && tt_best.is_null()) tt_best = prev_pv[ply];
+
     bool in_check = board.in_check();
-    if (in_check) depth++; // Check extension
+
+    // Static eval, computed once for all the pruning below (meaningless
+    // in check, where nothing is pruned)
+    int static_eval = 0;
+    if (!in_check) {
+        static_eval = evaluate(board);
+        if (board.side == BLACK_SIDE) static_eval = -static_eval;
+    }
+
+    // Improving: better than our eval two plies ago (assumed when unknown)
+    int prev_eval = ply >= 2 && ply - 2 < MAX_PLY ? static_evals[ply - 2] : EVAL_NONE;
+    if (ply < MAX_PLY) static_evals[ply] = in_check ? EVAL_NONE : static_eval;
+    bool improving = !in_check && (prev_eval == EVAL_NONE || static_eval > prev_eval);
+    // Not in a singular verification search either: its multi-cut
+    // result must come from searched moves, not a static eval
+    bool prune_ok = !pv_node && !in_check && !excluding && abs(beta) < MATE_IN_MAX_PLY;
+
+    // Reverse futility pruning: far enough above beta that a shallow
+    // search is not expected to bring it back down
+    if (prune_ok && depth <= 6 && static_eval - RFP_MARGIN * depth >= beta)
+        return static_eval;
+
+    // Razoring: far below alpha, only tactics can help, so ask quiescence
+    if (prune_ok && depth <= 3 && static_eval + RAZOR_MARGIN * depth < alpha) {
+        int q = quiescence(board, alpha, alpha + 1, ply);
+        if (stopped()) return 0;
+        if (q <= alpha) return q;
+    }
 
     // Null-move pruning
-    if (null_ok && !in_check && depth >= 3 && !is_endgame(board)) {
+    if (null_ok && !excluding && !in_check && depth >= 3 && static_eval >= beta &&
+        has_non_pawn_material(board)) {
         int R = depth >= 6 ? 3 : 2;
         UndoInfo undo;
         board.make_null_move(undo);
+        path_ext[ply + 1] = path_ext[ply];
         int null_score = -alphabeta(board, depth - 1 - R, -beta, -beta + 1, ply + 1, false);
         board.unmake_null_move(undo);
-        if (time_up) return 0;
+        if (stopped()) return 0;
         if (null_score >= beta) return beta;
     }
 
-    // Generate and check legal moves
-    Move moves[MAX_MOVES];
-    int n = board.gen_legal_moves(moves);
-
-    if (n == 0) {
-        return in_check ? -(MATE_SCORE - ply) : 0; // Checkmate or stalemate
+    // No TT move: at PV nodes find one with a shallower search (internal
+    // iterative deepening); elsewhere just search this node shallower
+    if (tt_best.is_null() && !excluding && depth >= 5) {
+        if (pv_node) {
+            alphabeta(board, depth - 2, alpha, beta, ply, true);
+            if (stopped()) return 0;
+            // Only the stored move is wanted, not another counted probe
+            int iid_score, iid_depth;
+            TTFlag iid_flag;
+            tt->lookup(board.hash, ply, iid_score, iid_depth, iid_flag, tt_best);
+            pv_length[ply] = 0;
+        } else {
+            depth--;
+        }
     }
 
-    // Move ordering
-    int scores[MAX_MOVES];
-    score_moves(board, moves, n, ply, tt_best, scores);
+    // Moves are generated lazily, stage by stage
+    MovePicker picker(board, tt_best, ply < MAX_PLY ? killers[ply] : nullptr,
+                      history[board.side]);
 
     int best_score = -INF_SCORE;
-    Move best_move = moves[0];
+    Move best_move;
     TTFlag tt_flag = TT_UPPER;
-
-    for (int i = 0; i < n; i++) {
-        sort_moves(moves, scores, n, i);
-        const Move& m = moves[i];
+    Move m;
+
+    // Futility pruning: quiet moves near the leaves cannot raise a
+    // static eval this far below alpha
+    bool futile = prune_ok && depth <= 3 &&
+                  static_eval + FUTILITY_MARGIN * depth <= alpha;
+
+    // Extensions: at most root_depth plies along any one path
+    bool ext_ok = path_ext[ply] < root_depth;
+
+    // Singular extension candidate: a deep enough TT lower bound whose
+    // move may be the only one that holds it
+    int se_score = 0, se_depth = 0;
+    TTFlag se_flag = TT_UPPER;
+    Move se_move;
+    bool se_ok = ext_ok && !excluding && depth >= SE_MIN_DEPTH && !tt_best.is_null() &&
+                 ply < MAX_PLY &&
+                 tt->lookup(board.hash, ply, se_score, se_depth, se_flag, se_move) &&
+                 se_flag != TT_UPPER && se_depth >= depth - 3 &&
+                 abs(se_score) < MATE_IN_MAX_PLY;
+
+    for (int i = 0; picker.next(m); i++) {
+        if (excluding && m == excl) { i--; continue; }
 
         bool is_cap = m.captured != 0;
         bool is_promo = m.promotion != 0;
+        int hist = history[board.side][m.from][m.to];
+        int ext = 0;
+
+        // Singular extension: search the others at reduced depth against
+        // a margin below the TT score; if all fail low, the TT move is
+        // singular. If even that margin beats beta, several moves do
+        // (multi-cut) and the node fails high.
+        if (se_ok && m == tt_best) {
+            int se_beta = se_score - 2 * depth;
+            excluded[ply] = m;
+            int s = alphabeta(board, (depth - 1) / 2, se_beta - 1, se_beta, ply, false);
+            excluded[ply] = Move();
+            pv_length[ply] = 0;
+            if (stopped()) return 0;
+            if (s < se_beta) ext = 1;
+            else if (se_beta >= beta) return se_beta;
+        }
 
         UndoInfo undo;
         board.make_move(m, undo);
         bool gives_check = board.in_check();
 
-        int score;
+        // A pruned move does not count toward the LMR move index
+        if (futile && i > 0 && !is_cap && !is_promo && !gives_check) {
+            board.unmake_move(m, undo);
+            i--;
+            continue;
+        }
 
-        // Late Move Reductions (LMR)
-        if (i >= 3 && depth >= 3 && !in_check && !gives_check &&
-            !is_cap && !is_promo) {
-            // Reduced search
-            int R = 1 + (i >= 6 ? 1 : 0) + (depth >= 6 ? 1 : 0);
-            score = -alphabeta(board, depth - 1 - R, -alpha - 1, -alpha, ply + 1, true);
+        // Check extension, within the same budget
+        if (gives_check && ext_ok) ext = 1;
+        path_ext[ply + 1] = path_ext[ply] + ext;
+        int new_depth = depth - 1 + ext;
+        follow_pv = on_pv && m == prev_pv[ply];
 
-            if (score > alpha) {
-                // Re-search at full depth
-                score = -alphabeta(board, depth - 1, -beta, -alpha, ply + 1, true);
-            }
+        int score;
+
+        if (i == 0) {
+            // First move gets the full window
+            score = -alphabeta(board, new_depth, -beta, -alpha, ply + 1, true);
         } else {
-            score = -alphabeta(board, depth - 1, -beta, -alpha, ply + 1, true);
+            // Late Move Reductions (LMR): reduced null-window search,
+            // less in PV nodes, when improving, or for proven quiets
+            int R = 0;
+            if (i >= 2 && depth >= 3 && !in_check && !gives_check &&
+                !is_cap && !is_promo) {
+                R = LMR_TABLE[std::min(depth, 63)][std::min(i, 63)];
+                if (pv_node) R--;
+                if (!improving) R++;
+                R -= std::min(hist / 8192, 2);
+                R = std::max(0, std::min(R, new_depth - 1));
+            }
+
+            // PVS: null window at full depth when unreduced or the reduced
+            // search beats alpha, then full window only on a PV improvement
+            score = -alphabeta(board, new_depth - R, -alpha - 1, -alpha, ply + 1, true);
+            if (R > 0 && score > alpha)
+                score = -alphabeta(board, new_depth, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && score < beta)
+                score = -alphabeta(board, new_depth, -beta, -alpha, ply + 1, true);
         }
 
         board.unmake_move(m, undo);
-        if (time_up) return 0;
+        if (stopped()) return 0;
 
         if (score > best_score) {
             best_score = score;
@@ -543,6 +919,7 @@ int Searcher::alphabeta(Board& board, int depth, int alpha, int beta,
         if (score > alpha) {
             alpha = score;
             tt_flag = TT_EXACT;
+            update_pv(ply, m);
 
             if (score >= beta) {
                 tt_flag = TT_LOWER;
@@ -569,7 +946,12 @@ int Searcher::alphabeta(Board& board, int depth, int alpha, int beta,
         }
     }
 
-    tt_store(board.hash, depth, best_score, tt_flag, best_move);
+    if (best_score == -INF_SCORE) {
+        if (excluding) return alpha; // Only the excluded move: singular
+        return in_check ? -(MATE_SCORE - ply) : 0; // Checkmate or stalemate
+    }
+
+    if (!excluding) tt_store(board.hash, depth, ply, best_score, tt_flag, best_move);
     return best_score;
 }
 
@@ -578,9 +960,12 @@ int Searcher::alphabeta(Board& board, int depth, int alpha, int beta,
 // ============================================================
 
 int Searcher::quiescence(Board& board, int alpha, int beta, int ply) {
-    nodes++;
+    count_node();
     if ((nodes & 4095) == 0) check_time();
-    if (time_up) return 0;
+    if (ply > seldepth) seldepth = ply;
+    if (ply < MAX_PLY) pv_length[ply] = 0;
+    follow_pv = false;
+    if (stopped()) return 0;
 
     int stand_pat = evaluate(board);
     if (board.side == BLACK_SIDE) stand_pat = -stand_pat;
@@ -603,24 +988,19 @@ int Searcher::quiescence(Board& board, int alpha, int beta, int ply) {
         scores[i] = victim * 10 - attacker;
     }
 
+    bool in_check = board.in_check();
     for (int i = 0; i < n; i++) {
         sort_moves(moves, scores, n, i);
 
-        // SEE-like pruning: skip clearly losing captures
-        if (scores[i] < -200 && !board.in_check()) continue;
+        // Skip captures that lose material by static exchange
+        if (!in_check && board.see(moves[i]) < 0) continue;
 
-        // Legality check
         UndoInfo undo;
         board.make_move(moves[i], undo);
-        if (board.is_attacked(board.king_sq[board.side ^ 1], board.side)) {
-            board.unmake_move(moves[i], undo);
-            continue; // Illegal
-        }
-
         int score = -quiescence(board, -beta, -alpha, ply + 1);
         board.unmake_move(moves[i], undo);
 
-        if (time_up) return 0;
+        if (stopped()) return 0;
         if (score >= beta) return beta;
         if (score > alpha) alpha = score;
     }
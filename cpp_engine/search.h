@@ -4,64 +4,201 @@
 // ============================================================
 
 #include "board.h"
-#include <vector>
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
 
 // ─── Transposition Table ───────────────────────────────────
 
 enum TTFlag : uint8_t { TT_EXACT = 0, TT_LOWER = 1, TT_UPPER = 2 };
 
+// 16-byte entry, four per 64-byte cluster (one cache line). The data
+// word packs move | score | depth | flag | generation, and the key is
+// stored XORed with it, so threads can read and write entries without
+// locks: a torn entry fails key verification instead of returning
+// another position's data.
 struct TTEntry {
+    std::atomic<uint64_t> key_xor;   // key ^ data
+    std::atomic<uint64_t> data;
+};
+
+constexpr int TT_CLUSTER_SIZE = 4;
+
+struct alignas(64) TTCluster {
+    TTEntry entries[TT_CLUSTER_SIZE];
+};
+
+class TranspositionTable {
+public:
+    explicit TranspositionTable(int size_mb);
+
+    // Start of a new search: entries from older generations are
+    // replaced first
+    void new_search() { generation = (generation + 1) & 63; }
+
+    // Mate scores are stored relative to the node (distance from it,
+    // not from the root), so 'ply' converts them on the way in and out
+    bool store(uint64_t key, int depth, int ply, int score, TTFlag flag,
+               const Move& best);
+    bool probe(uint64_t key, int depth, int ply, int alpha, int beta,
+               int& score, Move& best) const;
+    // Raw entry, whatever its depth and bound (singular extensions)
+    bool lookup(uint64_t key, int ply, int& score, int& depth, TTFlag& flag,
+                Move& best) const;
+
+    // Permille of sampled entries written by the current search
+    int hashfull() const;
+
+private:
+    std::unique_ptr<TTCluster[]> table;
+    uint64_t mask;
+    int generation;
+};
+
+// ─── Pawn hash table ───────────────────────────────────────
+// Pawn structure changes rarely between sibling nodes, so its
+// evaluation is cached per thread, keyed by Board::pawn_hash.
+
+struct PawnEntry {
     uint64_t key;
-    int16_t  score;
-    int8_t   depth;
-    TTFlag   flag;
-    Move     best;
+    int      score;          // Doubled/isolated/passed terms (White-positive)
+    Bitboard passed;         // Passed pawns of both sides
+    uint8_t  semi_open[2];   // Bit per file with no pawn of that side
+};
+
+constexpr int PAWN_TABLE_SIZE = 1 << 14;   // Entries, power of 2
+
+// ─── Search limits ─────────────────────────────────────────
+
+struct SearchLimits {
+    int      depth = 0;      // 0 = no depth limit
+    int      movetime = 0;   // Milliseconds; 0 = no time limit
+    uint64_t nodes = 0;      // Main-thread nodes; 0 = no node limit
+    const std::atomic<bool>* stop = nullptr;  // Set by another thread to abort
+    std::function<void()> started;            // On the searching thread, once
+                                              // the limits above are in force
 };
 
 struct SearchResult {
-    Move best_move;
-    int  score;
-    int  depth;
-    int  nodes;
-    int  time_ms;
-    int  tt_hits;
-    int  tt_stores;
+    Move     best_move;
+    int      score;
+    int      depth;
+    uint64_t nodes;      // Summed over all search threads
+    int      time_ms;
+    int      tt_hits;
+    int      tt_stores;
+    std::vector<Move> pv;    // Principal variation, starting with best_move
+};
+
+// Progress after each completed iteration (main thread)
+struct SearchInfo {
+    int      depth;
+    int      seldepth;       // Deepest ply reached, quiescence included
+    int      score;
+    uint64_t nodes;          // All threads
+    int      time_ms;
+    uint64_t nps;
+    int      hashfull;       // Permille
+    int      tt_hit_rate;    // Permille of TT probes that cut off
+    std::vector<Move> pv;
 };
 
 class Searcher {
 public:
-    Searcher(int tt_size_mb = 64);
+    Searcher(int tt_size_mb = 64, int threads = 1);
 
+    // Number of search threads (main + helpers), at least 1
+    void set_threads(int threads);
+    // Reallocates the TT (contents are lost)
+    void set_hash(int size_mb);
+
+    // Consecutive searches are treated as moves of one game: killers and
+    // history are aged, not wiped, and the TT only advances its
+    // generation. new_game() resets the ordering tables for a fresh game.
     SearchResult search(Board& board, int max_depth, int max_time_ms);
+    SearchResult search(Board& board, const SearchLimits& limits);
+    void new_game();
+
+    // Called on the searching thread after every completed iteration
+    using InfoCallback = std::function<void(const SearchInfo&)>;
+    void set_info_callback(InfoCallback cb) { info_callback = std::move(cb); }
+
+    // From another thread during a search started without a time limit
+    // (pondering): finish within movetime_ms from now
+    void ponderhit(int movetime_ms);
 
 private:
+    // Helper threads share the TT and stop flag of the main searcher
+    Searcher(std::shared_ptr<TranspositionTable> tt, std::atomic<bool>* stop, int id);
+
     // ─── Transposition Table ────────────────────────────────
-    std::vector<TTEntry> tt;
-    int tt_mask;
-    int tt_hits, tt_stores;
-    void tt_store(uint64_t key, int depth, int score, TTFlag flag, const Move& best);
-    bool tt_probe(uint64_t key, int depth, int alpha, int beta,
-                  int& score, Move& best) const;
-
-    // ─── Search state ───────────────────────────────────────
-    int nodes;
+    std::shared_ptr<TranspositionTable> tt;
+    int tt_hits, tt_stores, tt_probes;
+    void tt_store(uint64_t key, int depth, int ply, int score, TTFlag flag,
+                  const Move& best);
+    bool tt_probe(uint64_t key, int depth, int ply, int alpha, int beta,
+                  int& score, Move& best);
+
+    // ─── Threads ────────────────────────────────────────────
+    int thread_id;                                  // 0 = main thread
+    std::vector<std::unique_ptr<Searcher>> helpers; // Main thread only
+
+    // ─── Search state (per thread) ──────────────────────────
+    // Written only by its own thread; atomic so the main thread can sum
+    // node counts for progress reports while helpers run
+    std::atomic<uint64_t> nodes;
+    void count_node() { nodes.store(nodes.load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_relaxed); }
+    int seldepth;
     Move killers[MAX_PLY][2];
     int history[2][64][64];
+    int static_evals[MAX_PLY];     // Per ply; EVAL_NONE when in check
+    Move excluded[MAX_PLY];        // Move skipped by a singular verification
+    int path_ext[MAX_PLY + 1];     // Extensions on the path to each ply
+    int root_depth;                // Per-path extension budget
+
+    // ─── Principal variation ────────────────────────────────
+    // Triangular table: pv[ply] holds the line found from ply onwards.
+    // The previous iteration's PV (or the last search's, two plies on,
+    // if the game followed it) is tried first at nodes along it.
+    Move pv[MAX_PLY][MAX_PLY];
+    int pv_length[MAX_PLY];
+    void update_pv(int ply, const Move& m);
+    Move prev_pv[MAX_PLY];
+    int prev_pv_length;
+    bool follow_pv;                // Current path is a prefix of prev_pv
+    uint64_t next_root_hash;       // Position two plies down the last PV
+    void save_pv(const Board& root);
+    void age_tables(const Board& root);
 
     // ─── Time ───────────────────────────────────────────────
-    std::chrono::steady_clock::time_point start_time;
-    int max_time;
-    bool time_up;
+    std::atomic<int64_t> start_ms; // Steady-clock ms; ponderhit reads it
+    std::atomic<int> max_time;     // 0 = none; ponderhit sets it mid-search
+    uint64_t node_limit;
+    const std::atomic<bool>* external_stop;
+    std::atomic<bool> stop_flag;   // Owned by the main thread
+    std::atomic<bool>* stop;       // Points at the main thread's stop_flag
+    bool stopped() const { return stop->load(std::memory_order_relaxed); }
     void check_time();
+    int elapsed_ms() const;
+
+    // ─── Progress ───────────────────────────────────────────
+    InfoCallback info_callback;    // Main thread only
+    void report(int depth, int score, const Move& best);
 
     // ─── Core search ────────────────────────────────────────
-    int root_search(Board& board, int depth, Move& best_move);
+    SearchResult iterate(Board& board, int max_depth);
+
+    int root_search(Board& board, int depth, int alpha, int beta, Move& best_move);
     int alphabeta(Board& board, int depth, int alpha, int beta, int ply, bool null_ok);
     int quiescence(Board& board, int alpha, int beta, int ply);
 
     // ─── Evaluation ─────────────────────────────────────────
-    int evaluate(const Board& board) const;
+    std::vector<PawnEntry> pawn_table;
+    const PawnEntry& probe_pawns(const Board& board);
+    int evaluate(const Board& board);
 
     // ─── Move ordering ──────────────────────────────────────
     void score_moves(const Board& board, Move* moves, int count, int ply,
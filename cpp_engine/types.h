@@ -26,6 +26,12 @@ inline int sq_rank(int s)           { return s >> 3; }
 inline int make_sq(int f, int r)    { return (r << 3) | f; }
 inline int mirror_sq(int s)         { return s ^ 56; }
 inline bool sq_valid(int s)         { return s >= 0 && s < 64; }
+inline int sq_distance(int a, int b) {  // King moves from a to b
+    int df = sq_file(a) - sq_file(b), dr = sq_rank(a) - sq_rank(b);
+    if (df < 0) df = -df;
+    if (dr < 0) dr = -dr;
+    return df > dr ? df : dr;
+}
 
 // ─── Piece helpers ──────────────────────────────────────────
 inline int piece_type(int p)  { return p > 0 ? p : -p; }
@@ -67,6 +73,8 @@ struct Move {
     }
 
     static Move from_uci(const std::string& s, const int* board);
+    // Fills in captured piece and flags from the position (TT moves)
+    static Move from_squares(int from, int to, int promo, const int* board);
 };
 
 // ─── Undo info ──────────────────────────────────────────────
@@ -75,6 +83,7 @@ struct UndoInfo {
     int ep_square;
     int halfmove;
     uint64_t hash;
+    bool pushed;      // make_move recorded the position in the history
 };
 
 // ─── Constants ──────────────────────────────────────────────
@@ -82,6 +91,7 @@ constexpr int MAX_MOVES = 256;
 constexpr int MAX_PLY   = 128;
 constexpr int INF_SCORE = 100000;
 constexpr int MATE_SCORE = 99000;
+constexpr int MATE_IN_MAX_PLY = MATE_SCORE - MAX_PLY; // Beyond this: mate scores
 
 // Piece values
 constexpr int PIECE_VAL[] = { 0, 100, 320, 330, 500, 900, 20000 };
@@ -26,6 +26,7 @@ app.add_middleware(
 # ─── C++ Engine Process ─────────────────────────────────────────────────────
 
 CPP_ENGINE_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "cpp_engine", "chess_engine.exe")
+ENGINE_THREADS = int(os.environ.get("ENGINE_THREADS", "1"))  # Lazy SMP search threads
 cpp_process: subprocess.Popen = None
 
 def _start_cpp_engine():
@@ -44,6 +45,9 @@ def _start_cpp_engine():
         text=True, bufsize=1,
         env=env
     )
+    if ENGINE_THREADS > 1:
+        cpp_process.stdin.write(f"threads {ENGINE_THREADS}\n")
+        cpp_process.stdin.flush()
     print(f"C++ engine started (PID {cpp_process.pid})")
 
 def _stop_cpp_engine():
@@ -161,6 +165,18 @@ def _build_state(ai_info: Optional[dict] = None) -> GameState:
     )
 
 
+def _parse_info_line(line: str, info: dict):
+    """Keep seldepth, nps, hashfull and PV from an engine progress line."""
+    parts = line.split()
+    for key in ("seldepth", "nps", "hashfull"):
+        if key in parts:
+            i = parts.index(key)
+            if i + 1 < len(parts):
+                info[key] = int(parts[i + 1])
+    if "pv" in parts:
+        info["pv"] = parts[parts.index("pv") + 1:]
+
+
 def _do_ai_move() -> dict:
     """Send position to C++ engine, get best move back."""
     global cpp_process
@@ -168,14 +184,27 @@ def _do_ai_move() -> dict:
     if cpp_process is None or cpp_process.poll() is not None:
         _start_cpp_engine()
 
-    fen = board.fen()
+    # Start position plus the game's moves, so the engine knows which
+    # positions have already occurred (repetition draws)
+    position = board.root().fen()
+    if board.move_stack:
+        position += " moves " + " ".join(m.uci() for m in board.move_stack)
     safety_time = 120000  # 120s safety timeout
     info = {"depth": 0, "eval": 0, "time": 0, "nodes": 0, "tt_hits": 0, "tt_stores": 0}
 
     try:
-        cpp_process.stdin.write(f"{fen} | {search_depth} | {safety_time}\n")
+        cpp_process.stdin.write(f"{position} | {search_depth} | {safety_time}\n")
         cpp_process.stdin.flush()
-        response = cpp_process.stdout.readline().strip()
+        # Per-iteration "info" lines stream in before the final "bestmove"
+        while True:
+            response = cpp_process.stdout.readline()
+            if not response:
+                raise RuntimeError("engine closed its output")
+            response = response.strip()
+            if response.startswith("info "):
+                _parse_info_line(response, info)
+            elif response.startswith("bestmove"):
+                break
     except Exception as e:
         print(f"C++ engine error: {e}")
         _start_cpp_engine()
@@ -201,6 +230,8 @@ def _do_ai_move() -> dict:
             info["tt_hits"] = int(parts[i + 1]); i += 2
         elif k == "tt_stores" and i + 1 < len(parts):
             info["tt_stores"] = int(parts[i + 1]); i += 2
+        elif k == "pv":
+            info["pv"] = parts[i + 1:]; break
         else:
             i += 1
 
@@ -232,8 +263,13 @@ def new_game(req: NewGameRequest):
     search_depth = max(1, min(20, req.depth))
     move_history = []
 
-    # Restart C++ engine for fresh transposition table
-    _start_cpp_engine()
+    # Keep the engine process (and its TT allocation) across games; it
+    # only resets move-ordering tables and ages the TT
+    if cpp_process is None or cpp_process.poll() is not None:
+        _start_cpp_engine()
+    else:
+        cpp_process.stdin.write("newgame\n")
+        cpp_process.stdin.flush()
 
     state = _build_state()
     if ai_color == chess.WHITE: